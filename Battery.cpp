@@ -5,13 +5,29 @@
  *      Author: niklausd
  */
 
+#if defined (ARDUINO)
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
 #include "Battery.h"
 #include "BatteryImpl.h"
+#include "BatteryMetrics.h"
+#include "BatteryVoltageEvalTable.h"
 
 const float Battery::s_BATT_WARN_THRSHD = 6.5;
 const float Battery::s_BATT_STOP_THRSHD = 6.3;
 const float Battery::s_BATT_SHUT_THRSHD = 6.1;
 const float Battery::s_BATT_HYST        = 0.3;
+const unsigned int Battery::s_MIN_POLL_TIME = 500;
+const unsigned int Battery::s_MAX_POLL_TIME = 30000;
+const float Battery::s_POLL_DISTANCE_SPAN   = 0.5;
+const float Battery::s_CELL_IMBALANCE_THRSHD = 0.1;
+const float Battery::s_DROP_RATE_LIMIT = 0.05;
+const unsigned int Battery::s_NUM_CONFIRMATIONS = 3;
+const unsigned int Battery::s_DRAIN_TIME = 100;
+const float Battery::s_PREDICTION_HORIZON = 60.0;
+const unsigned int Battery::s_MAX_NUM_CELLS;
 
 BatteryAdapter::BatteryAdapter()
 : m_battery(0)
@@ -58,6 +74,37 @@ void BatteryAdapter::notifyBattStateAnyChange()
 //  }
 }
 
+unsigned int BatteryAdapter::readRawBattSenseValues(unsigned int* buffer, unsigned int count)
+{
+  unsigned int numRead = 0;
+  if (0 != buffer)
+  {
+    for (; numRead < count; numRead++)
+    {
+      buffer[numRead] = readRawBattSenseValue();
+    }
+  }
+  return numRead;
+}
+
+unsigned long BatteryAdapter::getUptimeMillis()
+{
+#if defined (ARDUINO)
+  return millis();
+#else
+  return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+unsigned long BatteryAdapter::getUptimeMicros()
+{
+#if defined (ARDUINO)
+  return micros();
+#else
+  return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
 float BatteryAdapter::readBattVoltageSenseFactor()
 {
   return 2.0;
@@ -109,7 +156,9 @@ const char* Battery::getCurrentStateName()
   {
     return "Battery::m_impl, null pointer exception";
   }
-  return m_impl->getCurrentStateName();
+  BatteryStatusSnapshot snapshot;
+  m_impl->getStatusSnapshot(snapshot);
+  return stateName(static_cast<BattVoltageEvalStateId>(snapshot.state));
 }
 
 const char* Battery::getPreviousStateName()
@@ -118,7 +167,9 @@ const char* Battery::getPreviousStateName()
   {
     return "Battery::m_impl, null pointer exception";
   }
-  return m_impl->getPreviousStateName();
+  BatteryStatusSnapshot snapshot;
+  m_impl->getStatusSnapshot(snapshot);
+  return stateName(static_cast<BattVoltageEvalStateId>(snapshot.previousState));
 }
 
 void Battery::battVoltageSensFactorChanged()
@@ -129,22 +180,218 @@ void Battery::battVoltageSensFactorChanged()
   }
 }
 
+void Battery::conversionComplete()
+{
+  if (0 != m_impl)
+  {
+    m_impl->conversionComplete();
+  }
+}
+
 float Battery::getBatteryVoltage()
 {
   float batteryVoltage = 0.0;
   if (0 != m_impl)
   {
-    batteryVoltage = m_impl->getBatteryVoltage();
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    batteryVoltage = snapshot.batteryVoltage;
   }
   return batteryVoltage;
 }
 
+float Battery::getStateOfCharge()
+{
+  float stateOfCharge = 0.0;
+  if (0 != m_impl)
+  {
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    stateOfCharge = snapshot.stateOfCharge;
+  }
+  return stateOfCharge;
+}
+
+float Battery::getTimeToEmpty()
+{
+  float timeToEmpty = BatteryStateOfCharge::s_TIME_TO_EMPTY_UNKNOWN;
+  if (0 != m_impl)
+  {
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    timeToEmpty = snapshot.timeToEmpty;
+  }
+  return timeToEmpty;
+}
+
+float Battery::getOpenCircuitVoltage()
+{
+  float openCircuitVoltage = 0.0;
+  if (0 != m_impl)
+  {
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    openCircuitVoltage = snapshot.openCircuitVoltage;
+  }
+  return openCircuitVoltage;
+}
+
+float Battery::getInternalResistance()
+{
+  float internalResistance = 0.0;
+  if (0 != m_impl)
+  {
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    internalResistance = snapshot.internalResistance;
+  }
+  return internalResistance;
+}
+
+float Battery::getTimeToWarn()
+{
+  float timeToWarn = BatteryVoltageTrend::s_TIME_UNKNOWN;
+  if (0 != m_impl)
+  {
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    timeToWarn = snapshot.timeToWarn;
+  }
+  return timeToWarn;
+}
+
+float Battery::getTimeToStop()
+{
+  float timeToStop = BatteryVoltageTrend::s_TIME_UNKNOWN;
+  if (0 != m_impl)
+  {
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    timeToStop = snapshot.timeToStop;
+  }
+  return timeToStop;
+}
+
+float Battery::getTimeToShutdown()
+{
+  float timeToShutdown = BatteryVoltageTrend::s_TIME_UNKNOWN;
+  if (0 != m_impl)
+  {
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    timeToShutdown = snapshot.timeToShutdown;
+  }
+  return timeToShutdown;
+}
+
+unsigned int Battery::getNumCells()
+{
+  unsigned int numCells = 0;
+  if (0 != m_impl)
+  {
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    numCells = snapshot.numCells;
+  }
+  return numCells;
+}
+
+float Battery::getMinCellVoltage()
+{
+  float minCellVoltage = 0.0;
+  if (0 != m_impl)
+  {
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    minCellVoltage = snapshot.minCellVoltage;
+  }
+  return minCellVoltage;
+}
+
+float Battery::getMaxCellVoltage()
+{
+  float maxCellVoltage = 0.0;
+  if (0 != m_impl)
+  {
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    maxCellVoltage = snapshot.maxCellVoltage;
+  }
+  return maxCellVoltage;
+}
+
+void Battery::setCellImbalanceThreshold(float cellImbalanceThreshold)
+{
+  if (0 != m_impl)
+  {
+    m_impl->setCellImbalanceThreshold(cellImbalanceThreshold);
+  }
+}
+
+float Battery::getBattCurrent()
+{
+  float battCurrent = 0.0;
+  if (0 != m_impl)
+  {
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    battCurrent = snapshot.battCurrent;
+  }
+  return battCurrent;
+}
+
+float Battery::getConsumedCharge()
+{
+  float consumedCharge = 0.0;
+  if (0 != m_impl)
+  {
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    consumedCharge = snapshot.consumedCharge;
+  }
+  return consumedCharge;
+}
+
+float Battery::getConsumedEnergy()
+{
+  float consumedEnergy = 0.0;
+  if (0 != m_impl)
+  {
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    consumedEnergy = snapshot.consumedEnergy;
+  }
+  return consumedEnergy;
+}
+
+void Battery::resetConsumption()
+{
+  if (0 != m_impl)
+  {
+    m_impl->resetConsumption();
+  }
+}
+
+void Battery::getStatusSnapshot(BatteryStatusSnapshot& snapshot)
+{
+  if (0 != m_impl)
+  {
+    m_impl->getStatusSnapshot(snapshot);
+  }
+  else
+  {
+    memset(&snapshot, 0, sizeof(snapshot));
+  }
+}
+
 bool Battery::isBattVoltageOk()
 {
   bool isVoltageOk = true;
   if (0 != m_impl)
   {
-    isVoltageOk = m_impl->isBattVoltageOk();
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    isVoltageOk = (BattStateOk == snapshot.state);
   }
   return isVoltageOk;
 }
@@ -154,7 +401,9 @@ bool Battery::isBattVoltageBelowWarnThreshold()
   bool isVoltageBelowWarnThreshold = false;
   if (0 != m_impl)
   {
-    isVoltageBelowWarnThreshold = m_impl->isBattVoltageBelowWarnThreshold();
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    isVoltageBelowWarnThreshold = (BattStateVoltageBelowWarn <= snapshot.state) && (BattStateVoltageBelowShutdown >= snapshot.state);
   }
   return isVoltageBelowWarnThreshold;
 }
@@ -164,7 +413,9 @@ bool Battery::isBattVoltageBelowStopThreshold()
   bool isVoltageBelowStopThreshold = false;
   if (0 != m_impl)
   {
-    isVoltageBelowStopThreshold = m_impl->isBattVoltageBelowStopThreshold();
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    isVoltageBelowStopThreshold = (BattStateVoltageBelowStop <= snapshot.state) && (BattStateVoltageBelowShutdown >= snapshot.state);
   }
   return isVoltageBelowStopThreshold;
 }
@@ -174,7 +425,9 @@ bool Battery::isBattVoltageBelowShutdownThreshold()
   bool isVoltageBelowShutdownThreshold = false;
   if (0 != m_impl)
   {
-    isVoltageBelowShutdownThreshold = m_impl->isBattVoltageBelowShutdownThreshold();
+    BatteryStatusSnapshot snapshot;
+    m_impl->getStatusSnapshot(snapshot);
+    isVoltageBelowShutdownThreshold = (BattStateVoltageBelowShutdown == snapshot.state);
   }
   return isVoltageBelowShutdownThreshold;
 }
@@ -187,3 +440,184 @@ void Battery::evaluateBatteryStateAsync()
   }
 }
 
+void Battery::configureSampleFilter(BattSampleFilterMode mode, unsigned int oversampling, unsigned int windowSize, float alpha)
+{
+  if (0 != m_impl)
+  {
+    m_impl->configureSampleFilter(mode, oversampling, windowSize, alpha);
+  }
+}
+
+void Battery::configureAdaptivePolling(bool isAdaptive, unsigned int minPollTime, unsigned int maxPollTime, float distanceSpan)
+{
+  if (0 != m_impl)
+  {
+    m_impl->configureAdaptivePolling(isAdaptive, minPollTime, maxPollTime, distanceSpan);
+  }
+}
+
+void Battery::configureOcvEstimation(bool isEnabled, float initialResistance, float voltageNoise, float ocvDrift)
+{
+  if (0 != m_impl)
+  {
+    m_impl->configureOcvEstimation(isEnabled, initialResistance, voltageNoise, ocvDrift);
+  }
+}
+
+void Battery::configureTrendPrediction(bool isEnabled, unsigned int windowSize, float predictionHorizon)
+{
+  if (0 != m_impl)
+  {
+    m_impl->configureTrendPrediction(isEnabled, windowSize, predictionHorizon);
+  }
+}
+
+void Battery::configurePushMode(bool isPushMode, unsigned int drainTime)
+{
+  if (0 != m_impl)
+  {
+    m_impl->configurePushMode(isPushMode, drainTime);
+  }
+}
+
+bool Battery::pushRawSample(unsigned int rawBattSenseValue, unsigned long timestampMillis)
+{
+  bool isQueued = false;
+  if (0 != m_impl)
+  {
+    isQueued = m_impl->pushRawSample(rawBattSenseValue, timestampMillis);
+  }
+  return isQueued;
+}
+
+unsigned long Battery::getNumRejectedSamples()
+{
+  unsigned long numRejectedSamples = 0;
+  if (0 != m_impl)
+  {
+    numRejectedSamples = m_impl->numRejectedSamples();
+  }
+  return numRejectedSamples;
+}
+
+void Battery::configureFastTransitions(bool isEnabled, float dropRateLimit, unsigned int numConfirmations)
+{
+  if (0 != m_impl)
+  {
+    m_impl->configureFastTransitions(isEnabled, dropRateLimit, numConfirmations);
+  }
+}
+
+void Battery::evaluateBatteryState()
+{
+  if (0 != m_impl)
+  {
+    m_impl->evaluateStatus();
+  }
+}
+
+void Battery::attachTelemetryRecorder(BatteryTelemetryRecorder* recorder, unsigned long channel)
+{
+  if (0 != m_impl)
+  {
+    m_impl->attachTelemetryRecorder(recorder, channel);
+  }
+}
+
+void Battery::setTableEvalEngine(bool isTableEngine)
+{
+  if (0 != m_impl)
+  {
+    m_impl->setTableEvalEngine(isTableEngine);
+  }
+}
+
+bool Battery::setThresholdConfig(BatteryThresholdConfig batteryThresholdConfig)
+{
+  bool isAccepted = false;
+  if (0 != m_impl)
+  {
+    isAccepted = m_impl->setThresholdConfig(batteryThresholdConfig);
+  }
+  return isAccepted;
+}
+
+BatteryThresholdConfig Battery::getThresholdConfig()
+{
+  BatteryThresholdConfig batteryThresholdConfig = { s_BATT_WARN_THRSHD, s_BATT_STOP_THRSHD, s_BATT_SHUT_THRSHD, s_BATT_HYST };
+  if (0 != m_impl)
+  {
+    m_impl->getThresholdConfig(batteryThresholdConfig);
+  }
+  return batteryThresholdConfig;
+}
+
+bool Battery::isValidThresholdConfig(BatteryThresholdConfig batteryThresholdConfig)
+{
+  // written as positive checks, NaN values fail all of them
+  return ((batteryThresholdConfig.battWarnThreshd > batteryThresholdConfig.battStopThrshd) &&
+          (batteryThresholdConfig.battStopThrshd  > batteryThresholdConfig.battShutThrshd) &&
+          (batteryThresholdConfig.battHyst >= 0.0));
+}
+
+void Battery::configureStateOfCharge(bool isEnabled, BattChemistry chemistry, unsigned int numCells)
+{
+  if (0 != m_impl)
+  {
+    m_impl->configureStateOfCharge(isEnabled, chemistry, numCells);
+  }
+}
+
+void Battery::configureTransitionQualification(BatteryQualificationConfig qualificationConfig)
+{
+  if (0 != m_impl)
+  {
+    m_impl->configureTransitionQualification(qualificationConfig);
+  }
+}
+
+const BatteryTransitionHistory* Battery::getTransitionHistory()
+{
+  const BatteryTransitionHistory* history = 0;
+  if (0 != m_impl)
+  {
+    history = m_impl->transitionHistory();
+  }
+  return history;
+}
+
+bool Battery::getMetrics(BatteryMetrics& metrics)
+{
+  bool isEnabled = false;
+  if (0 != m_impl)
+  {
+    isEnabled = m_impl->getMetrics(metrics);
+  }
+  else
+  {
+    memset(&metrics, 0, sizeof(metrics));
+  }
+  return isEnabled;
+}
+
+void Battery::resetMetrics()
+{
+  if (0 != m_impl)
+  {
+    m_impl->resetMetrics();
+  }
+}
+
+void Battery::setIntegerEvaluation(bool isIntegerEvaluation)
+{
+  if (0 != m_impl)
+  {
+    m_impl->setIntegerEvaluation(isIntegerEvaluation);
+  }
+}
+
+
+const char* Battery::stateName(BattVoltageEvalStateId stateId)
+{
+  return BatteryVoltageEvalTableFsm::stateName(stateId);
+}
@@ -8,30 +8,45 @@
 #ifndef BATTERY_H_
 #define BATTERY_H_
 
+#include "BatterySampleFilter.h"
+#include "BatteryStatusSnapshot.h"
+#include "BatteryStateOfCharge.h"
+#include "BatteryCoulombCounter.h"
+#include "BatteryVoltageTrend.h"
+#include "BatteryOcvEstimator.h"
+
 //-----------------------------------------------------------------------------
 
 class Battery;
 
-class BatteryAdapter
+/**
+ * Default ADC full range of the target platform.
+ */
+struct BatteryAdcDefaults
 {
-private:
 #if defined (__arm__) && defined (__SAM3X8E__) // Arduino Due
-  const float s_V_ADC_FULLRANGE = 3.3;
-  const unsigned int s_N_ADC_FULLRANGE = 1023;
+  static constexpr float s_V_ADC_FULLRANGE = 3.3;
+  static constexpr unsigned int s_N_ADC_FULLRANGE = 1023;
 #elif defined (ARDUINO_ARCH_SAMD) && defined (__SAMD21G18A__) // Adafruit Feather M0
-  const float s_V_ADC_FULLRANGE = 3.3;
-  const unsigned int s_N_ADC_FULLRANGE = 1023;
+  static constexpr float s_V_ADC_FULLRANGE = 3.3;
+  static constexpr unsigned int s_N_ADC_FULLRANGE = 1023;
 #elif defined (__AVR__)
-  const float s_V_ADC_FULLRANGE = 5.0;
-  const unsigned int s_N_ADC_FULLRANGE = 1023;
+  static constexpr float s_V_ADC_FULLRANGE = 5.0;
+  static constexpr unsigned int s_N_ADC_FULLRANGE = 1023;
 #elif defined ESP8266
-  const float s_V_ADC_FULLRANGE = 1.0;
-  const unsigned int s_N_ADC_FULLRANGE = 1023;
+  static constexpr float s_V_ADC_FULLRANGE = 1.0;
+  static constexpr unsigned int s_N_ADC_FULLRANGE = 1023;
 #else
-  const float s_V_ADC_FULLRANGE = 3.1;
-  const unsigned int s_N_ADC_FULLRANGE = 4095;
+  static constexpr float s_V_ADC_FULLRANGE = 3.1;
+  static constexpr unsigned int s_N_ADC_FULLRANGE = 4095;
 #endif
+};
+
+//-----------------------------------------------------------------------------
 
+class BatteryAdapter
+{
+private:
   Battery* m_battery;
 
 public:
@@ -42,18 +57,121 @@ public:
   virtual void notifyBattStateAnyChange();
   virtual float readBattVoltageSenseFactor();
 
+  /**
+   * Notify the cell voltage spread of a pack has exceeded the imbalance threshold, see Battery::setCellImbalanceThreshold().
+   * Fired once per excursion, re-armed when the spread has dropped below the threshold again.
+   * @param cellImbalance Difference between the highest and the lowest cell voltage [V].
+   */
+  virtual void notifyBattCellImbalance(float cellImbalance) { }
+
+  /**
+   * Notify the voltage trend predicts the shutdown threshold to be reached within the prediction horizon,
+   * see Battery::configureTrendPrediction(). Fired once per excursion, re-armed when the prediction has moved
+   * beyond the horizon again; not fired while the voltage is below the shutdown threshold already.
+   * @param timeToShutdown Predicted time until the shutdown threshold is reached [s].
+   */
+  virtual void notifyBattShutdownPredicted(float timeToShutdown) { }
+
   virtual unsigned int readRawBattSenseValue() = 0;
 
+  /**
+   * Read a burst of raw Battery Voltage sense values in one call.
+   * Override this in DMA capable or buffered backends, the default implementation calls readRawBattSenseValue() count times.
+   * @param buffer Buffer to be filled with raw ADC counts.
+   * @param count Number of raw samples requested (buffer size).
+   * @return Number of raw samples actually written to the buffer.
+   */
+  virtual unsigned int readRawBattSenseValues(unsigned int* buffer, unsigned int count);
+
+  /**
+   * Split-phase acquisition: start a non-blocking conversion, override in interrupt or DMA driven backends.
+   * The Battery then polls isConversionComplete() on the following scheduler ticks (or is told so by
+   * Battery::conversionComplete()) and picks up the results with readRawBattSenseValues() or, in pack mode,
+   * readRawCellSenseValues(), which must not block anymore by then.
+   * Only the Battery's own timers (poll, evaluateBatteryStateAsync()) use the split-phase path,
+   * Battery::evaluateBatteryState() always reads synchronously.
+   * @param count Number of raw values to be converted: the oversampling burst, or getNumCells() cell channels.
+   * @return true if a conversion has been started, false: not supported, read synchronously (default).
+   */
+  virtual bool startConversion(unsigned int count)
+  {
+    return false;
+  }
+
+  /**
+   * Split-phase acquisition: check if the conversion started by startConversion() has completed.
+   * @return true if the results are ready to be read (default).
+   */
+  virtual bool isConversionComplete()
+  {
+    return true;
+  }
+
+  /**
+   * Number of series cells with an own sense channel, override in multi-cell pack backends.
+   * With cell channels the Battery evaluates the weakest cell instead of the pack voltage channel.
+   * Read at construction and on Battery::battVoltageSensFactorChanged(), call that after changing the number of cells.
+   * @return Number of cell channels [0..Battery::s_MAX_NUM_CELLS], 0: single pack voltage channel (default).
+   */
+  virtual unsigned int getNumCells()
+  {
+    return 0;
+  }
+
+  /**
+   * Read the raw sense values of all cell channels (cell voltages, not tap voltages).
+   * @param buffer Buffer to be filled with raw ADC counts, one per cell.
+   * @param count Number of cells, as returned by getNumCells().
+   * @return Number of raw values actually written to the buffer, the evaluation is skipped if less than count.
+   */
+  virtual unsigned int readRawCellSenseValues(unsigned int* buffer, unsigned int count)
+  {
+    return 0;
+  }
+
+  /**
+   * Sense factor (voltage divider ratio) of the cell channels, default: 1.0 (cell voltage within the ADC full range).
+   */
+  virtual float readCellVoltageSenseFactor()
+  {
+    return 1.0;
+  }
+
+  /**
+   * Read the Battery Current, override in backends with a current sense channel.
+   * The Battery integrates the current into the consumed charge and energy at the sample rate.
+   * @param battCurrent Battery Current [A], positive: discharging.
+   * @return true if a current has been read, false: no current sense channel (default).
+   */
+  virtual bool readBattCurrent(float& battCurrent)
+  {
+    return false;
+  }
+
   virtual float getVAdcFullrange()
   {
-    return s_V_ADC_FULLRANGE;
+    return BatteryAdcDefaults::s_V_ADC_FULLRANGE;
   }
 
   virtual unsigned int getNAdcFullrange()
   {
-    return s_N_ADC_FULLRANGE;
+    return BatteryAdcDefaults::s_N_ADC_FULLRANGE;
   }
 
+  /**
+   * Time base for the status timestamps, default: millis() on Arduino, the monotonic system clock otherwise.
+   * Override to provide a different (e.g. virtual) clock.
+   * @return Uptime [ms].
+   */
+  virtual unsigned long getUptimeMillis();
+
+  /**
+   * High resolution time base for the metrics (latencies, poll jitter), default: micros() on Arduino,
+   * the monotonic system clock otherwise. Only used if BATTERY_METRICS_ENABLED.
+   * @return Uptime [us].
+   */
+  virtual unsigned long getUptimeMicros();
+
   virtual ~BatteryAdapter() { }
 
   void attachBattery(Battery* battery);
@@ -70,6 +188,9 @@ private:  // forbidden default functions
 //-----------------------------------------------------------------------------
 
 class BatteryImpl;
+class BatteryTelemetryRecorder;
+struct BatteryMetrics;
+class BatteryTransitionHistory;
 
 //-----------------------------------------------------------------------------
 
@@ -83,6 +204,51 @@ struct BatteryThresholdConfig
 
 //-----------------------------------------------------------------------------
 
+/**
+ * Battery Voltage Evaluation State identifiers, one for each state of the BatteryVoltageEvalFsm.
+ */
+enum BattVoltageEvalStateId
+{
+  BattStateUnknown = 0,
+  BattStateOk,
+  BattStateVoltageBelowWarn,
+  BattStateVoltageBelowStop,
+  BattStateVoltageBelowShutdown,
+  BattStateNumStates
+};
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Battery Voltage Evaluation State transition.
+ */
+struct BatteryTransitionEvent
+{
+  unsigned char previousState;    /// BattVoltageEvalStateId left
+  unsigned char state;            /// BattVoltageEvalStateId entered
+  float batteryVoltage;           /// Battery Voltage that caused the transition [V]
+  unsigned long timestampMillis;  /// time of the transition [ms]
+  unsigned long sampleIndex;      /// index of the sample that caused the transition
+};
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Battery Voltage Evaluation State transition qualification.
+ * A proposed transition commits once it has been proposed in at least requiredCount of the last windowSize
+ * evaluations (N-of-M) and has been pending for at least minDwellMillis. Transitions out of BattStateUnknown
+ * are never delayed. The defaults { 1, 1, 0, false } keep the unqualified legacy behaviour.
+ */
+struct BatteryQualificationConfig
+{
+  unsigned int requiredCount;      /// N: number of proposals needed within the window
+  unsigned int windowSize;         /// M: number of evaluations in the window, 1..32
+  unsigned long minDwellMillis;    /// minimum time a transition has to be pending before it commits [ms]
+  bool isCoalescing;               /// true: suppress self transitions (repeated entry actions and notifications)
+};
+
+//-----------------------------------------------------------------------------
+
 class Battery
 {
 public:
@@ -118,12 +284,69 @@ public:
    */
   void battVoltageSensFactorChanged();
 
+  /**
+   * Notify the conversion started by BatteryAdapter::startConversion() has completed.
+   * Safe to be called from an interrupt service routine, the results are evaluated on the next scheduler tick.
+   * Optional: without this notification BatteryAdapter::isConversionComplete() is polled.
+   */
+  void conversionComplete();
+
   /**
    * Read the currently measured Battery Voltage.
    * @return Currently measured Battery Voltage [V].
    */
   float getBatteryVoltage();
 
+  /**
+   * Get a consistent snapshot of the Battery status as of the latest evaluation.
+   * Lock-free, safe to be called from any thread while the status is being evaluated.
+   * The voltage, state and state name getters of this class are based on the same snapshot.
+   * @param snapshot Snapshot object to be filled in.
+   */
+  void getStatusSnapshot(BatteryStatusSnapshot& snapshot);
+
+  /**
+   * Get the state of charge estimate, see configureStateOfCharge().
+   * @return State of charge [%], 0 if the estimator is disabled.
+   */
+  float getStateOfCharge();
+
+  /**
+   * Get the time to empty estimate at the current discharge rate, see configureStateOfCharge().
+   * @return Time to empty [s], BatteryStateOfCharge::s_TIME_TO_EMPTY_UNKNOWN if not discharging or disabled.
+   */
+  float getTimeToEmpty();
+
+  /**
+   * Get the estimated open circuit voltage, see configureOcvEstimation().
+   * @return Open circuit voltage [V], 0 if the estimator is disabled.
+   */
+  float getOpenCircuitVoltage();
+
+  /**
+   * Get the estimated internal resistance, see configureOcvEstimation().
+   * @return Internal resistance [Ohm], 0 if the estimator is disabled.
+   */
+  float getInternalResistance();
+
+  /**
+   * Get the predicted time until the voltage falls below the warn threshold, see configureTrendPrediction().
+   * @return Time [s], 0 if below already, BatteryVoltageTrend::s_TIME_UNKNOWN if not falling or disabled.
+   */
+  float getTimeToWarn();
+
+  /**
+   * Get the predicted time until the voltage falls below the stop threshold, see configureTrendPrediction().
+   * @return Time [s], 0 if below already, BatteryVoltageTrend::s_TIME_UNKNOWN if not falling or disabled.
+   */
+  float getTimeToStop();
+
+  /**
+   * Get the predicted time until the voltage falls below the shutdown threshold, see configureTrendPrediction().
+   * @return Time [s], 0 if below already, BatteryVoltageTrend::s_TIME_UNKNOWN if not falling or disabled.
+   */
+  float getTimeToShutdown();
+
   /**
    * Check if the currently measured Battery Voltage is ok.
    * @return true, if voltage is above the warning threshold level, false otherwise.
@@ -153,10 +376,245 @@ public:
    */
   void evaluateBatteryStateAsync();
 
+  /**
+   * Evaluate Battery state synchronously (read, convert, evaluate and notify within this call).
+   * Used by external drivers such as the BatteryEvalRuntime instead of the internal poll timer.
+   */
+  void evaluateBatteryState();
+
+  /**
+   * Configure the raw sample filter stage between the BatteryAdapter and the evaluation.
+   * Default: no oversampling, no filter (each poll evaluates one single raw sample).
+   * @param mode Noise filter algorithm.
+   * @param oversampling Number of raw samples averaged per poll [1..BatterySampleFilter::s_MAX_OVERSAMPLING].
+   * @param windowSize Window of the moving average and median filters [1..BatterySampleFilter::s_MAX_WINDOW_SIZE].
+   * @param alpha Smoothing factor of the exponential filter [BatterySampleFilter::s_MIN_ALPHA..1], clamped.
+   */
+  void configureSampleFilter(BattSampleFilterMode mode, unsigned int oversampling = 1, unsigned int windowSize = 1, float alpha = 1.0);
+
+  /**
+   * Configure adaptive status polling.
+   * When enabled, the poll interval follows the distance of the latest Battery Voltage to the nearest threshold
+   * level (sparse when healthy, dense near a transition) and is shortened further while the voltage is falling
+   * towards the next level. When disabled (default), the status is polled every 5 s.
+   * @param isAdaptive true: adaptive poll interval, false: fixed default poll interval
+   * @param minPollTime Shortest poll interval [ms].
+   * @param maxPollTime Longest poll interval [ms].
+   * @param distanceSpan Threshold distance from which on the longest poll interval applies [V].
+   */
+  void configureAdaptivePolling(bool isAdaptive, unsigned int minPollTime = Battery::s_MIN_POLL_TIME, unsigned int maxPollTime = Battery::s_MAX_POLL_TIME, float distanceSpan = Battery::s_POLL_DISTANCE_SPAN);
+
+  /**
+   * Configure the open circuit voltage (OCV) estimator.
+   * When enabled, the thresholds are evaluated against the estimated OCV instead of the measured, load sagged
+   * voltage (in pack mode: against the weakest cell's equivalent). The estimator fuses the voltage with the
+   * BatteryAdapter::readBattCurrent() signal and tracks the internal resistance online. The OCV is only evaluated
+   * for samples with a current value; without one the measured voltage is, so that a smoothing filter never delays
+   * the shutdown. A measurement far off the prediction (e.g. a sudden collapse) restarts the OCV at the measurement.
+   * Adaptive polling, fast transitions, the trend prediction and the transition history then follow the OCV as well.
+   * Disabled by default.
+   * @param isEnabled true: evaluate the estimated OCV, false: evaluate the measured voltage (default)
+   * @param initialResistance Internal resistance assumed until tracked [Ohm].
+   * @param voltageNoise Standard deviation of the voltage measurement [V].
+   * @param ocvDrift How fast the OCV may move [V/sqrt(s)], larger: follows faster, smooths less.
+   */
+  void configureOcvEstimation(bool isEnabled, float initialResistance = BatteryOcvEstimator::s_INITIAL_RESISTANCE, float voltageNoise = BatteryOcvEstimator::s_VOLTAGE_NOISE, float ocvDrift = BatteryOcvEstimator::s_OCV_DRIFT);
+
+  /**
+   * Configure the threshold crossing prediction.
+   * When enabled, a least-squares slope is fitted over the latest evaluated voltages and extrapolated to the
+   * warn, stop and shutdown thresholds (see getTimeToWarn(), getTimeToStop(), getTimeToShutdown()).
+   * BatteryAdapter::notifyBattShutdownPredicted() is fired when the shutdown threshold is predicted within the horizon.
+   * @param isEnabled true: predict, false: no prediction (default)
+   * @param windowSize Number of evaluations the slope is fitted over [2..BatteryVoltageTrend::s_MAX_WINDOW_SIZE (BATTERY_TREND_WINDOW_SIZE)].
+   * @param predictionHorizon Shutdown prediction notification lead time [s].
+   */
+  void configureTrendPrediction(bool isEnabled, unsigned int windowSize = BatteryVoltageTrend::s_DEFAULT_WINDOW_SIZE, float predictionHorizon = Battery::s_PREDICTION_HORIZON);
+
+  /**
+   * Configure push mode sample ingestion.
+   * In push mode the Battery does not read the BatteryAdapter's sense channels anymore, a producer pushes
+   * timestamped raw samples with pushRawSample() instead. The poll timer (or evaluateBatteryState()) drains
+   * them every drainTime and evaluates each one in order, through the sample filter stage (without oversampling).
+   * Adaptive polling does not apply in push mode. When disabled (default), the Battery polls the adapter.
+   * @param isPushMode true: evaluate pushed samples, false: read the adapter on each poll
+   * @param drainTime Interval the pushed samples are evaluated at [ms], should be short enough for the
+   *                  producer not to fill the BatterySampleQueue::s_CAPACITY samples in between.
+   */
+  void configurePushMode(bool isPushMode, unsigned int drainTime = Battery::s_DRAIN_TIME);
+
+  /**
+   * Push mode: queue a raw Battery Voltage sense value for evaluation.
+   * Wait-free, for exactly one producer (e.g. a sampler thread or an ADC interrupt service routine),
+   * concurrently to the evaluating loop.
+   * @param rawBattSenseValue Raw ADC count.
+   * @param timestampMillis Acquisition time, same time base as BatteryAdapter::getUptimeMillis() [ms].
+   * @return true if queued, false if the queue is full (the sample is dropped and counted, see getNumRejectedSamples()).
+   */
+  bool pushRawSample(unsigned int rawBattSenseValue, unsigned long timestampMillis);
+
+  /**
+   * Push mode: number of samples pushRawSample() has rejected because the queue was full.
+   */
+  unsigned long getNumRejectedSamples();
+
+  /**
+   * Configure the fast transition path for sharp voltage collapses.
+   * When enabled, a sample that is below several levels at once steps down through all of them within the same
+   * evaluation, firing the entry notifications of the skipped levels in order (e.g. Ok, Warn, Stop, Shutdown).
+   * A voltage drop faster than the limit additionally triggers a burst of immediate confirmation evaluations,
+   * which also feeds the transition qualification without waiting for the next polls.
+   * When disabled (default), the state changes by one level per evaluation.
+   * @param isEnabled true: multi-level transitions and confirmation bursts, false: one level per evaluation
+   * @param dropRateLimit Voltage drop rate from which on the confirmation burst is triggered [V/s].
+   * @param numConfirmations Number of confirmation evaluations per burst, 0: none.
+   */
+  void configureFastTransitions(bool isEnabled, float dropRateLimit = Battery::s_DROP_RATE_LIMIT, unsigned int numConfirmations = Battery::s_NUM_CONFIRMATIONS);
+
+  /**
+   * Attach a telemetry recorder (e.g. a BatteryTelemetryLog), receiving one record per evaluated sample.
+   * @param recorder Pointer to a BatteryTelemetryRecorder object, 0: none
+   * @param channel Channel number written to the records, identifies this Battery in a shared log, default: 0
+   */
+  void attachTelemetryRecorder(BatteryTelemetryRecorder* recorder, unsigned long channel = 0);
+
+  /**
+   * Select the Battery Voltage evaluation engine.
+   * @param isTableEngine true: table driven engine (BatteryVoltageEvalTableFsm), false: state class engine (default)
+   */
+  void setTableEvalEngine(bool isTableEngine);
+
+  /**
+   * Get the number of cell channels evaluated in pack mode, see BatteryAdapter::getNumCells().
+   * @return Number of cells, 0: single pack voltage channel.
+   */
+  unsigned int getNumCells();
+
+  /**
+   * Get the lowest cell voltage of the latest evaluation (pack mode only, 0 otherwise).
+   * @return Cell voltage [V].
+   */
+  float getMinCellVoltage();
+
+  /**
+   * Get the highest cell voltage of the latest evaluation (pack mode only, 0 otherwise).
+   * @return Cell voltage [V].
+   */
+  float getMaxCellVoltage();
+
+  /**
+   * Set the cell voltage spread above which BatteryAdapter::notifyBattCellImbalance() is fired.
+   * @param cellImbalanceThreshold Imbalance threshold [V], default: Battery::s_CELL_IMBALANCE_THRSHD.
+   */
+  void setCellImbalanceThreshold(float cellImbalanceThreshold);
+
+  /**
+   * Get the Battery Current of the latest evaluation, see BatteryAdapter::readBattCurrent().
+   * @return Battery Current [A], positive: discharging, 0 without current sense channel.
+   */
+  float getBattCurrent();
+
+  /**
+   * Get the charge consumed since startup or resetConsumption().
+   * @return Consumed charge [mAh].
+   */
+  float getConsumedCharge();
+
+  /**
+   * Get the energy consumed since startup or resetConsumption().
+   * @return Consumed energy [Wh].
+   */
+  float getConsumedEnergy();
+
+  /**
+   * Restart the consumed charge and energy accounting.
+   */
+  void resetConsumption();
+
+  /**
+   * Replace the threshold configuration at runtime, without restarting the evaluation.
+   * The new levels take effect with the next evaluation, the current state is kept.
+   * Thread safe against the evaluation and the status readers, one configuring thread at a time.
+   * @param batteryThresholdConfig New threshold configuration.
+   * @return true if accepted, false if invalid (see isValidThresholdConfig()), the previous configuration stays active.
+   */
+  bool setThresholdConfig(BatteryThresholdConfig batteryThresholdConfig);
+
+  /**
+   * Get the active threshold configuration.
+   */
+  BatteryThresholdConfig getThresholdConfig();
+
+  /**
+   * Check a threshold configuration: warn > stop > shutdown threshold and a non-negative hysteresis.
+   */
+  static bool isValidThresholdConfig(BatteryThresholdConfig batteryThresholdConfig);
+
+  /**
+   * Configure the state of charge and time to empty estimator (default: disabled).
+   * The state of charge is looked up at the estimated open circuit voltage if configureOcvEstimation() is enabled,
+   * at the Battery Voltage otherwise.
+   * @param isEnabled true: update the estimate on each evaluation.
+   * @param chemistry Cell chemistry, selects the open circuit voltage curve.
+   * @param numCells Number of cells in series.
+   */
+  void configureStateOfCharge(bool isEnabled, BattChemistry chemistry = BattChemistryLiPo, unsigned int numCells = 2);
+
+  /**
+   * Configure debouncing of the Battery Voltage Evaluation State transitions, see BatteryQualificationConfig.
+   * @param qualificationConfig Transition qualification parameters.
+   */
+  void configureTransitionQualification(BatteryQualificationConfig qualificationConfig);
+
+  /**
+   * Get the latest Battery Voltage Evaluation State transitions (see BatteryTransitionHistory.h), accessed in place
+   * without copying, e.g. from a diagnostics command or a crash handler. Only state changes are recorded,
+   * self-transitions (repeated shutdown state entries) are not.
+   * @return Transition history, 0 if not available.
+   */
+  const BatteryTransitionHistory* getTransitionHistory();
+
+  /**
+   * Copy the instrumentation counters (see BatteryMetrics.h), from the context driving the evaluation.
+   * @param metrics Object to be filled in.
+   * @return true if the metrics are compiled in (BATTERY_METRICS_ENABLED), false: metrics zeroed.
+   */
+  bool getMetrics(BatteryMetrics& metrics);
+
+  /**
+   * Clear the instrumentation counters.
+   */
+  void resetMetrics();
+
+  /**
+   * Select integer domain evaluation.
+   * The threshold levels are pre-converted to raw ADC counts (on threshold or sense factor changes), the state class engine
+   * then compares the raw ADC count directly and the Battery Voltage is only computed when requested (getBatteryVoltage(),
+   * status snapshot readers, telemetry, adaptive polling).
+   * @param isIntegerEvaluation true: evaluate in raw ADC counts, false: evaluate the Battery Voltage (default)
+   */
+  void setIntegerEvaluation(bool isIntegerEvaluation);
+
+  /**
+   * Get the name of a Battery Voltage Evaluation State.
+   * @param stateId Battery Voltage Evaluation State identifier.
+   * @return State name, same as the one returned by getCurrentStateName().
+   */
+  static const char* stateName(BattVoltageEvalStateId stateId);
+
   static const float s_BATT_WARN_THRSHD;            /// default Battery Voltage Warn Threshold [V]
   static const float s_BATT_STOP_THRSHD;            /// default Battery Voltage Stop Actors Threshold [V]
   static const float s_BATT_SHUT_THRSHD;            /// default Battery Voltage Shutdown Threshold [V]
   static const float s_BATT_HYST;                   /// default Battery Voltage Hysteresis around Threshold levels [V]
+  static const unsigned int s_MIN_POLL_TIME;        /// default adaptive polling shortest poll interval [ms]
+  static const unsigned int s_MAX_POLL_TIME;        /// default adaptive polling longest poll interval [ms]
+  static const float s_POLL_DISTANCE_SPAN;          /// default adaptive polling threshold distance span [V]
+  static const float s_CELL_IMBALANCE_THRSHD;       /// default pack mode cell imbalance threshold [V]
+  static const float s_DROP_RATE_LIMIT;             /// default fast transitions confirmation burst drop rate limit [V/s]
+  static const unsigned int s_NUM_CONFIRMATIONS;    /// default fast transitions number of confirmation evaluations
+  static const unsigned int s_DRAIN_TIME;           /// default push mode drain interval [ms]
+  static const float s_PREDICTION_HORIZON;          /// default shutdown prediction notification lead time [s]
+  static const unsigned int s_MAX_NUM_CELLS = 16;   /// maximum number of cell channels in pack mode
 
 private:
   BatteryImpl* m_impl;  /// Pointer to the private implementation of the Battery component object.
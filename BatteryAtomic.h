@@ -0,0 +1,40 @@
+/*
+ * BatteryAtomic.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYATOMIC_H_
+#define BATTERYATOMIC_H_
+
+/**
+ * Minimal word sized atomic access and fences for lock-free data exchange between an evaluating
+ * thread (or ISR) and concurrent readers.
+ * Maps to the GCC / Clang __atomic builtins; on AVR, where all access happens from the single
+ * cooperative main loop, volatile access is sufficient.
+ */
+class BatteryAtomic
+{
+public:
+#if defined (__AVR__)
+  static unsigned long load(const volatile unsigned long* ptr)              { return *ptr; }
+  static unsigned long loadAcquire(const volatile unsigned long* ptr)       { return *ptr; }
+  static void store(volatile unsigned long* ptr, unsigned long value)       { *ptr = value; }
+  static void storeRelease(volatile unsigned long* ptr, unsigned long value){ *ptr = value; }
+  static void fenceAcquire()                                                { __asm__ __volatile__ ("" ::: "memory"); }
+  static void fenceRelease()                                                { __asm__ __volatile__ ("" ::: "memory"); }
+#else
+  static unsigned long load(const volatile unsigned long* ptr)              { return __atomic_load_n(ptr, __ATOMIC_RELAXED); }
+  static unsigned long loadAcquire(const volatile unsigned long* ptr)       { return __atomic_load_n(ptr, __ATOMIC_ACQUIRE); }
+  static void store(volatile unsigned long* ptr, unsigned long value)       { __atomic_store_n(ptr, value, __ATOMIC_RELAXED); }
+  static void storeRelease(volatile unsigned long* ptr, unsigned long value){ __atomic_store_n(ptr, value, __ATOMIC_RELEASE); }
+  static void fenceAcquire()                                                { __atomic_thread_fence(__ATOMIC_ACQUIRE); }
+  static void fenceRelease()                                                { __atomic_thread_fence(__ATOMIC_RELEASE); }
+#endif
+
+private: // forbidden default functions
+  BatteryAtomic();
+};
+
+#endif /* BATTERYATOMIC_H_ */
@@ -0,0 +1,62 @@
+/*
+ * BatteryCoulombCounter.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#include "BatteryCoulombCounter.h"
+
+BatteryCoulombCounter::BatteryCoulombCounter()
+: m_isValid(false)
+, m_current(0)
+, m_power(0)
+, m_timestampMillis(0)
+, m_charge(0)
+, m_energy(0)
+{ }
+
+void BatteryCoulombCounter::reset()
+{
+  m_isValid = false;
+  m_current = 0;
+  m_power = 0;
+  m_timestampMillis = 0;
+  m_charge = 0;
+  m_energy = 0;
+}
+
+void BatteryCoulombCounter::update(float batteryVoltage, float battCurrent, unsigned long timestampMillis)
+{
+  double current = static_cast<double>(battCurrent) * s_MICROS_PER_UNIT;   // [uA]
+  double power = batteryVoltage * current;                                  // [uW]
+  int64_t currentMicroAmps = static_cast<int64_t>((current < 0.0) ? (current - 0.5) : (current + 0.5));
+  int64_t powerMicroWatts = static_cast<int64_t>((power < 0.0) ? (power - 0.5) : (power + 0.5));
+  if (m_isValid)
+  {
+    int64_t deltaMillis = static_cast<unsigned long>(timestampMillis - m_timestampMillis);
+    m_charge += (m_current + currentMicroAmps) * deltaMillis;
+    m_energy += (m_power + powerMicroWatts) * deltaMillis;
+  }
+  m_isValid = true;
+  m_current = currentMicroAmps;
+  m_power = powerMicroWatts;
+  m_timestampMillis = timestampMillis;
+}
+
+float BatteryCoulombCounter::battCurrent()
+{
+  return static_cast<float>(m_current) / s_MICROS_PER_UNIT;
+}
+
+float BatteryCoulombCounter::consumedCharge()
+{
+  // [uA*ms] -> [mAh]
+  return static_cast<float>(static_cast<double>(m_charge) / (2 * s_MILLIS_PER_HOUR * (s_MICROS_PER_UNIT / 1000)));
+}
+
+float BatteryCoulombCounter::consumedEnergy()
+{
+  // [uW*ms] -> [Wh]
+  return static_cast<float>(static_cast<double>(m_energy) / (2 * s_MILLIS_PER_HOUR * s_MICROS_PER_UNIT));
+}
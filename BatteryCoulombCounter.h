@@ -0,0 +1,70 @@
+/*
+ * BatteryCoulombCounter.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYCOULOMBCOUNTER_H_
+#define BATTERYCOULOMBCOUNTER_H_
+
+#include <stdint.h>
+
+/**
+ * Streaming charge and energy integrator.
+ *
+ * Each sample's current and power are rounded to uA and uW and integrated with the trapezoidal rule into
+ * 64 bit uA*ms and uW*ms accumulators, so the totals are exact sums of integer increments, sub-mA loads
+ * (e.g. sleep currents) included, and do not overflow within the lifetime of a battery (2^63 uA*ms is
+ * more than 10^9 mAh).
+ */
+class BatteryCoulombCounter
+{
+public:
+  BatteryCoulombCounter();
+
+  /**
+   * Discard the accumulated charge and energy, the next update() starts a new integration.
+   */
+  void reset();
+
+  /**
+   * Integrate one sample.
+   * @param batteryVoltage Battery Voltage [V].
+   * @param battCurrent Battery Current [A], positive: discharging.
+   * @param timestampMillis Time of the sample [ms].
+   */
+  void update(float batteryVoltage, float battCurrent, unsigned long timestampMillis);
+
+  /**
+   * Battery Current of the latest sample [A].
+   */
+  float battCurrent();
+
+  /**
+   * Charge consumed since the last reset() [mAh], negative if more has been charged than discharged.
+   */
+  float consumedCharge();
+
+  /**
+   * Energy consumed since the last reset() [Wh], negative if more has been charged than discharged.
+   */
+  float consumedEnergy();
+
+  static const int64_t s_MILLIS_PER_HOUR = 3600000;
+  static const int64_t s_MICROS_PER_UNIT = 1000000;   /// uA per A, uW per W
+
+private:
+  bool m_isValid;                   /// at least one update() since the last reset()
+  int64_t m_current;                /// latest current [uA]
+  int64_t m_power;                  /// latest power [uW]
+  unsigned long m_timestampMillis;  /// time of the latest update() [ms]
+  int64_t m_charge;                 /// accumulated charge, twice the trapezoidal sum [uA*ms]
+  int64_t m_energy;                 /// accumulated energy, twice the trapezoidal sum [uW*ms]
+
+private: // forbidden default functions
+  BatteryCoulombCounter& operator = (const BatteryCoulombCounter& src); // assignment operator
+  BatteryCoulombCounter(const BatteryCoulombCounter& src);              // copy constructor
+};
+
+#endif /* BATTERYCOULOMBCOUNTER_H_ */
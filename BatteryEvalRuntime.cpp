@@ -0,0 +1,157 @@
+/*
+ * BatteryEvalRuntime.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#if !defined (ARDUINO)
+
+#include "Battery.h"
+#include "BatteryEvalRuntime.h"
+
+const unsigned int BatteryEvalRuntime::s_CHUNK_SIZE = 64;
+
+BatteryEvalRuntime::BatteryEvalRuntime(unsigned int numThreads)
+: m_batteries()
+, m_workers()
+, m_shards(0)
+, m_numThreads((0 != numThreads) ? numThreads : std::thread::hardware_concurrency())
+, m_mutex()
+, m_roundStart()
+, m_roundDone()
+, m_round(0)
+, m_numBusyWorkers(0)
+, m_isStopping(false)
+{
+  if (0 == m_numThreads)
+  {
+    m_numThreads = 1;
+  }
+  m_shards = new Shard[m_numThreads];
+  for (unsigned int i = 0; i < m_numThreads; i++)
+  {
+    m_shards[i].next = 0;
+    m_shards[i].end = 0;
+  }
+  // the caller of evaluateAll() acts as worker 0
+  for (unsigned int i = 1; i < m_numThreads; i++)
+  {
+    m_workers.push_back(std::thread(&BatteryEvalRuntime::workerLoop, this, i));
+  }
+}
+
+BatteryEvalRuntime::~BatteryEvalRuntime()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isStopping = true;
+  }
+  m_roundStart.notify_all();
+  for (unsigned int i = 0; i < m_workers.size(); i++)
+  {
+    m_workers[i].join();
+  }
+  delete [] m_shards;
+  m_shards = 0;
+}
+
+void BatteryEvalRuntime::attachBattery(Battery* battery)
+{
+  if (0 != battery)
+  {
+    m_batteries.push_back(battery);
+  }
+}
+
+unsigned int BatteryEvalRuntime::numBatteries()
+{
+  return static_cast<unsigned int>(m_batteries.size());
+}
+
+unsigned int BatteryEvalRuntime::numThreads()
+{
+  return m_numThreads;
+}
+
+void BatteryEvalRuntime::evaluateAll()
+{
+  unsigned int numBatteries = static_cast<unsigned int>(m_batteries.size());
+  for (unsigned int i = 0; i < m_numThreads; i++)
+  {
+    m_shards[i].next.store(static_cast<unsigned int>(static_cast<unsigned long long>(numBatteries) * i / m_numThreads), std::memory_order_relaxed);
+    m_shards[i].end = static_cast<unsigned int>(static_cast<unsigned long long>(numBatteries) * (i + 1) / m_numThreads);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_numBusyWorkers = m_numThreads - 1;
+    m_round++;
+  }
+  m_roundStart.notify_all();
+
+  evaluateShards(0);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (0 != m_numBusyWorkers)
+  {
+    m_roundDone.wait(lock);
+  }
+}
+
+void BatteryEvalRuntime::workerLoop(unsigned int workerIndex)
+{
+  unsigned long round = 0;
+  for (;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      while (!m_isStopping && (round == m_round))
+      {
+        m_roundStart.wait(lock);
+      }
+      if (m_isStopping)
+      {
+        return;
+      }
+      round = m_round;
+    }
+
+    evaluateShards(workerIndex);
+
+    bool isLast = false;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_numBusyWorkers--;
+      isLast = (0 == m_numBusyWorkers);
+    }
+    if (isLast)
+    {
+      m_roundDone.notify_one();
+    }
+  }
+}
+
+void BatteryEvalRuntime::evaluateShards(unsigned int workerIndex)
+{
+  // own shard first, then steal from the others, starting with the neighbor
+  for (unsigned int i = 0; i < m_numThreads; i++)
+  {
+    Shard& shard = m_shards[(workerIndex + i) % m_numThreads];
+    for (;;)
+    {
+      unsigned int begin = shard.next.fetch_add(s_CHUNK_SIZE, std::memory_order_relaxed);
+      if (begin >= shard.end)
+      {
+        break;
+      }
+      unsigned int end = (shard.end - begin < s_CHUNK_SIZE) ? shard.end : begin + s_CHUNK_SIZE;
+      for (unsigned int j = begin; j < end; j++)
+      {
+        m_batteries[j]->evaluateBatteryState();
+      }
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * BatteryEvalRuntime.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYEVALRUNTIME_H_
+#define BATTERYEVALRUNTIME_H_
+
+#if !defined (ARDUINO)
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Battery;
+
+/**
+ * Multi-threaded evaluation runtime for hosts watching many Battery objects.
+ *
+ * The attached Battery objects are sharded into one contiguous range per thread. evaluateAll() evaluates
+ * every Battery exactly once: each thread works through its own range chunk by chunk and then steals
+ * chunks from the ranges of the other threads. Since a Battery is evaluated by one thread per round and
+ * rounds do not overlap, the notification order of each Battery stays deterministic.
+ * The attached BatteryAdapter objects are called from the worker threads, one thread per Battery at a time.
+ */
+class BatteryEvalRuntime
+{
+public:
+  /**
+   * Constructor, starts the worker threads.
+   * @param numThreads Number of threads evaluating in parallel including the caller of evaluateAll(), 0: number of hardware threads.
+   */
+  BatteryEvalRuntime(unsigned int numThreads = 0);
+
+  /**
+   * Destructor, stops and joins the worker threads.
+   */
+  virtual ~BatteryEvalRuntime();
+
+  /**
+   * Attach a Battery to be evaluated, not to be called concurrently with evaluateAll().
+   */
+  void attachBattery(Battery* battery);
+
+  /**
+   * Number of attached Battery objects.
+   */
+  unsigned int numBatteries();
+
+  /**
+   * Number of threads evaluating in parallel, including the caller of evaluateAll().
+   */
+  unsigned int numThreads();
+
+  /**
+   * Evaluate the status of all attached Battery objects once, returns when all are done.
+   */
+  void evaluateAll();
+
+  static const unsigned int s_CHUNK_SIZE;   /// number of Battery objects claimed at once
+
+private:
+  struct Shard
+  {
+    std::atomic<unsigned int> next;   /// next index to be claimed
+    unsigned int end;
+    unsigned char padding[64 - sizeof(std::atomic<unsigned int>) - sizeof(unsigned int)];   /// keep the shards on separate cache lines
+  };
+
+  void workerLoop(unsigned int workerIndex);
+  void evaluateShards(unsigned int workerIndex);
+
+private:
+  std::vector<Battery*> m_batteries;
+  std::vector<std::thread> m_workers;
+  Shard* m_shards;
+  unsigned int m_numThreads;
+
+  std::mutex m_mutex;
+  std::condition_variable m_roundStart;
+  std::condition_variable m_roundDone;
+  unsigned long m_round;
+  unsigned int m_numBusyWorkers;
+  bool m_isStopping;
+
+private: // forbidden default functions
+  BatteryEvalRuntime& operator = (const BatteryEvalRuntime& src); // assignment operator
+  BatteryEvalRuntime(const BatteryEvalRuntime& src);              // copy constructor
+};
+
+#endif
+
+#endif /* BATTERYEVALRUNTIME_H_ */
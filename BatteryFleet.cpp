@@ -0,0 +1,213 @@
+/*
+ * BatteryFleet.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#include "BatteryVoltageConverter.h"
+#include "BatteryFleet.h"
+
+const unsigned int BatteryFleet::s_INVALID_INDEX = ~0u;
+
+BatteryFleet::BatteryFleet(unsigned int capacity, float vAdcFullrange, unsigned int nAdcFullrange, BatteryFleetAdapter* adapter)
+: m_adapter(adapter)
+, m_capacity(capacity)
+, m_size(0)
+, m_adcScale(BatteryVoltageConverter::conversionCoefficient(1.0, vAdcFullrange, nAdcFullrange))
+, m_rawBattSenseValue(new unsigned int[capacity])
+, m_battVoltageConvCoeff(new float[capacity])
+, m_batteryVoltage(new float[capacity])
+, m_battWarnThreshd(new float[capacity])
+, m_battStopThrshd(new float[capacity])
+, m_battShutThrshd(new float[capacity])
+, m_battWarnThreshdPlusHyst(new float[capacity])
+, m_battStopThrshdPlusHyst(new float[capacity])
+, m_battShutThrshdPlusHyst(new float[capacity])
+, m_state(new unsigned char[capacity])
+, m_previousState(new unsigned char[capacity])
+{ }
+
+BatteryFleet::~BatteryFleet()
+{
+  delete [] m_previousState;
+  delete [] m_state;
+  delete [] m_battShutThrshdPlusHyst;
+  delete [] m_battStopThrshdPlusHyst;
+  delete [] m_battWarnThreshdPlusHyst;
+  delete [] m_battShutThrshd;
+  delete [] m_battStopThrshd;
+  delete [] m_battWarnThreshd;
+  delete [] m_batteryVoltage;
+  delete [] m_battVoltageConvCoeff;
+  delete [] m_rawBattSenseValue;
+
+  m_adapter = 0;
+}
+
+void BatteryFleet::attachAdapter(BatteryFleetAdapter* adapter)
+{
+  m_adapter = adapter;
+}
+
+BatteryFleetAdapter* BatteryFleet::adapter()
+{
+  return m_adapter;
+}
+
+unsigned int BatteryFleet::addBattery(float battVoltageSenseFactor, BatteryThresholdConfig batteryThresholdConfig)
+{
+  if (m_size >= m_capacity)
+  {
+    return s_INVALID_INDEX;
+  }
+  unsigned int index = m_size;
+  m_size++;
+  m_rawBattSenseValue[index] = 0;
+  m_batteryVoltage[index] = 0.0;
+  m_state[index] = BattStateUnknown;
+  m_previousState[index] = BattStateUnknown;
+  setBattVoltageSenseFactor(index, battVoltageSenseFactor);
+  setThresholdConfig(index, batteryThresholdConfig);
+  return index;
+}
+
+unsigned int BatteryFleet::size()
+{
+  return m_size;
+}
+
+unsigned int BatteryFleet::capacity()
+{
+  return m_capacity;
+}
+
+void BatteryFleet::setRawBattSenseValue(unsigned int index, unsigned int rawBattSenseValue)
+{
+  if (index < m_size)
+  {
+    m_rawBattSenseValue[index] = rawBattSenseValue;
+  }
+}
+
+unsigned int* BatteryFleet::rawBattSenseValues()
+{
+  return m_rawBattSenseValue;
+}
+
+void BatteryFleet::setBattVoltageSenseFactor(unsigned int index, float battVoltageSenseFactor)
+{
+  if (index < m_size)
+  {
+    m_battVoltageConvCoeff[index] = battVoltageSenseFactor * m_adcScale;
+  }
+}
+
+void BatteryFleet::setThresholdConfig(unsigned int index, BatteryThresholdConfig batteryThresholdConfig)
+{
+  if (index < m_size)
+  {
+    m_battWarnThreshd[index] = batteryThresholdConfig.battWarnThreshd;
+    m_battStopThrshd[index]  = batteryThresholdConfig.battStopThrshd;
+    m_battShutThrshd[index]  = batteryThresholdConfig.battShutThrshd;
+    m_battWarnThreshdPlusHyst[index] = batteryThresholdConfig.battWarnThreshd + batteryThresholdConfig.battHyst;
+    m_battStopThrshdPlusHyst[index]  = batteryThresholdConfig.battStopThrshd  + batteryThresholdConfig.battHyst;
+    m_battShutThrshdPlusHyst[index]  = batteryThresholdConfig.battShutThrshd  + batteryThresholdConfig.battHyst;
+  }
+}
+
+unsigned int BatteryFleet::evaluate()
+{
+  // pass 1: signal conversion, no dependencies between the packs
+  BatteryVoltageConverter::convert(m_rawBattSenseValue, m_battVoltageConvCoeff, m_batteryVoltage, m_size);
+
+  // pass 2: state evaluation, transition rules as implemented by the BatteryVoltageEvalFsmState_* classes
+  unsigned int numTransitions = 0;
+  for (unsigned int i = 0; i < m_size; i++)
+  {
+    float voltage = m_batteryVoltage[i];
+    unsigned char state = m_state[i];
+    unsigned char nextState = state;
+    bool isTransition = false;
+
+    switch (state)
+    {
+      case BattStateUnknown:
+        isTransition = true;
+        if (m_battWarnThreshdPlusHyst[i] < voltage)     { nextState = BattStateOk; }
+        else if (m_battWarnThreshd[i] > voltage)        { nextState = BattStateVoltageBelowWarn; }
+        else if (m_battStopThrshd[i] > voltage)         { nextState = BattStateVoltageBelowStop; }
+        else if (m_battShutThrshd[i] > voltage)         { nextState = BattStateVoltageBelowShutdown; }
+        else                                            { isTransition = false; }
+        break;
+      case BattStateOk:
+        if (m_battWarnThreshd[i] > voltage)             { nextState = BattStateVoltageBelowWarn; isTransition = true; }
+        break;
+      case BattStateVoltageBelowWarn:
+        isTransition = true;
+        if (m_battStopThrshd[i] > voltage)              { nextState = BattStateVoltageBelowStop; }
+        else if (m_battWarnThreshdPlusHyst[i] < voltage){ nextState = BattStateOk; }
+        else                                            { isTransition = false; }
+        break;
+      case BattStateVoltageBelowStop:
+        isTransition = true;
+        if (m_battShutThrshd[i] > voltage)              { nextState = BattStateVoltageBelowShutdown; }
+        else if (m_battStopThrshdPlusHyst[i] < voltage) { nextState = BattStateVoltageBelowWarn; }
+        else                                            { isTransition = false; }
+        break;
+      case BattStateVoltageBelowShutdown:
+      default:
+        // re-enters itself as long as the voltage stays below shutdown threshold plus hysteresis
+        isTransition = true;
+        nextState = (m_battShutThrshdPlusHyst[i] < voltage) ? BattStateVoltageBelowWarn : BattStateVoltageBelowShutdown;
+        break;
+    }
+
+    if (isTransition)
+    {
+      numTransitions++;
+      m_previousState[i] = state;
+      m_state[i] = nextState;
+      if (0 != m_adapter)
+      {
+        m_adapter->notifyBattStateChange(i, static_cast<BattVoltageEvalStateId>(state), static_cast<BattVoltageEvalStateId>(nextState));
+      }
+    }
+  }
+  return numTransitions;
+}
+
+float BatteryFleet::getBatteryVoltage(unsigned int index)
+{
+  float batteryVoltage = 0.0;
+  if (index < m_size)
+  {
+    batteryVoltage = m_batteryVoltage[index];
+  }
+  return batteryVoltage;
+}
+
+BattVoltageEvalStateId BatteryFleet::state(unsigned int index)
+{
+  BattVoltageEvalStateId stateId = BattStateUnknown;
+  if (index < m_size)
+  {
+    stateId = static_cast<BattVoltageEvalStateId>(m_state[index]);
+  }
+  return stateId;
+}
+
+BattVoltageEvalStateId BatteryFleet::previousState(unsigned int index)
+{
+  BattVoltageEvalStateId stateId = BattStateUnknown;
+  if (index < m_size)
+  {
+    stateId = static_cast<BattVoltageEvalStateId>(m_previousState[index]);
+  }
+  return stateId;
+}
+
+const char* BatteryFleet::getCurrentStateName(unsigned int index)
+{
+  return Battery::stateName(state(index));
+}
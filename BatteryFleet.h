@@ -0,0 +1,144 @@
+/*
+ * BatteryFleet.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYFLEET_H_
+#define BATTERYFLEET_H_
+
+#include "Battery.h"
+
+//-----------------------------------------------------------------------------
+
+class BatteryFleetAdapter
+{
+public:
+  /**
+   * Notify a Battery Voltage Evaluation State transition of one pack of the fleet.
+   * Same as in the BatteryVoltageEvalFsm, a pack staying below the shutdown threshold re-enters its state on every evaluation.
+   * @param index Index of the pack within the fleet.
+   * @param previousState State the pack was in before the transition.
+   * @param state State the pack has entered.
+   */
+  virtual void notifyBattStateChange(unsigned int index, BattVoltageEvalStateId previousState, BattVoltageEvalStateId state) { }
+
+  virtual ~BatteryFleetAdapter() { }
+
+protected:
+  BatteryFleetAdapter() { }
+
+private:  // forbidden default functions
+  BatteryFleetAdapter& operator = (const BatteryFleetAdapter& src); // assignment operator
+  BatteryFleetAdapter(const BatteryFleetAdapter& src);              // copy constructor
+};
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Batch evaluator for a large number of battery packs.
+ *
+ * All per-pack data (raw ADC counts, sense factors, threshold levels, voltages and states) is kept in
+ * contiguous struct-of-arrays storage. evaluate() runs the whole fleet in one pass with the same
+ * warn / stop / shutdown / hysteresis semantics as the BatteryVoltageEvalFsm.
+ */
+class BatteryFleet
+{
+public:
+  /**
+   * Constructor.
+   * @param capacity Maximum number of packs the fleet can hold.
+   * @param vAdcFullrange ADC full range voltage [V].
+   * @param nAdcFullrange ADC full range count.
+   * @param adapter Pointer to a specific BatteryFleetAdapter object, default: 0 (none)
+   */
+  BatteryFleet(unsigned int capacity, float vAdcFullrange, unsigned int nAdcFullrange, BatteryFleetAdapter* adapter = 0);
+
+  /**
+   * Destructor.
+   */
+  virtual ~BatteryFleet();
+
+  /**
+   * Attach a specific BatteryFleetAdapter object.
+   * @param adapter Pointer to a specific BatteryFleetAdapter object.
+   */
+  void attachAdapter(BatteryFleetAdapter* adapter);
+
+  /**
+   * Get the pointer to the currently attached specific BatteryFleetAdapter object.
+   * @return BatteryFleetAdapter object pointer, might be 0 if none is attached.
+   */
+  BatteryFleetAdapter* adapter();
+
+  /**
+   * Add a pack to the fleet, the pack starts in BattStateUnknown.
+   * @param battVoltageSenseFactor Battery Voltage Sense Factor of the pack.
+   * @param batteryThresholdConfig Threshold configuration of the pack.
+   * @return Index of the new pack, s_INVALID_INDEX if the fleet is full.
+   */
+  unsigned int addBattery(float battVoltageSenseFactor, BatteryThresholdConfig batteryThresholdConfig);
+
+  /**
+   * Number of packs currently in the fleet.
+   */
+  unsigned int size();
+
+  /**
+   * Maximum number of packs the fleet can hold.
+   */
+  unsigned int capacity();
+
+  /**
+   * Set the raw ADC count of one pack, to be evaluated by the next evaluate() call.
+   */
+  void setRawBattSenseValue(unsigned int index, unsigned int rawBattSenseValue);
+
+  /**
+   * Direct access to the contiguous raw ADC count array (size() elements), for bulk acquisition.
+   */
+  unsigned int* rawBattSenseValues();
+
+  void setBattVoltageSenseFactor(unsigned int index, float battVoltageSenseFactor);
+  void setThresholdConfig(unsigned int index, BatteryThresholdConfig batteryThresholdConfig);
+
+  /**
+   * Convert the raw ADC counts of all packs and evaluate their states in one pass.
+   * @return Number of state transitions (including shutdown re-entries) in this pass.
+   */
+  unsigned int evaluate();
+
+  float getBatteryVoltage(unsigned int index);
+  BattVoltageEvalStateId state(unsigned int index);
+  BattVoltageEvalStateId previousState(unsigned int index);
+  const char* getCurrentStateName(unsigned int index);
+
+  static const unsigned int s_INVALID_INDEX;
+
+private:
+  BatteryFleetAdapter* m_adapter;
+  unsigned int m_capacity;
+  unsigned int m_size;
+  float m_adcScale;                   /// ADC full range voltage per count [V]
+
+  unsigned int* m_rawBattSenseValue;
+  float* m_battVoltageConvCoeff;      /// combined raw count to voltage conversion coefficients [V]
+  float* m_batteryVoltage;
+  float* m_battWarnThreshd;           /// Battery Voltage Warn Threshold [V]
+  float* m_battStopThrshd;            /// Battery Voltage Stop Actors Threshold [V]
+  float* m_battShutThrshd;            /// Battery Voltage Shutdown Threshold [V]
+  float* m_battWarnThreshdPlusHyst;   /// Battery Voltage Warn Threshold plus Hysteresis [V]
+  float* m_battStopThrshdPlusHyst;    /// Battery Voltage Stop Actors Threshold plus Hysteresis [V]
+  float* m_battShutThrshdPlusHyst;    /// Battery Voltage Shutdown Threshold plus Hysteresis [V]
+  unsigned char* m_state;
+  unsigned char* m_previousState;
+
+private: // forbidden default functions
+  BatteryFleet& operator = (const BatteryFleet& src); // assignment operator
+  BatteryFleet(const BatteryFleet& src);              // copy constructor
+};
+
+//-----------------------------------------------------------------------------
+
+#endif /* BATTERYFLEET_H_ */
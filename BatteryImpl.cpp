@@ -8,7 +8,10 @@
 #include "SpinTimer.h"
 #include "Battery.h"
 #include "BatteryVoltageEvalFsm.h"
+#include "BatteryVoltageConverter.h"
 #include "BatteryImpl.h"
+#include "BatteryTelemetryLog.h"
+#include "BatteryAtomic.h"
 
 //-----------------------------------------------------------------------------
 
@@ -47,7 +50,49 @@ public:
   {
     if (0 != m_battImpl)
     {
-      m_battImpl->evaluateStatus();
+      m_battImpl->startEvaluation();
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+class BattPollTimerAction : public SpinTimerAction
+{
+private:
+  BatteryImpl* m_battImpl;
+
+public:
+  BattPollTimerAction(BatteryImpl* battImpl)
+  : m_battImpl(battImpl)
+  { }
+
+  void timeExpired()
+  {
+    if (0 != m_battImpl)
+    {
+      m_battImpl->pollTimerExpired();
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+class BattConversionTimerAction : public SpinTimerAction
+{
+private:
+  BatteryImpl* m_battImpl;
+
+public:
+  BattConversionTimerAction(BatteryImpl* battImpl)
+  : m_battImpl(battImpl)
+  { }
+
+  void timeExpired()
+  {
+    if (0 != m_battImpl)
+    {
+      m_battImpl->conversionTimerExpired();
     }
   }
 };
@@ -57,25 +102,90 @@ public:
 const unsigned int BatteryImpl::s_DEFAULT_STARTUP_TIME = 500;
 const unsigned int BatteryImpl::s_DEFAULT_POLL_TIME = 5000;
 const unsigned int BatteryImpl::s_DEFAULT_ASYNC_STATUS_EVAL_TIME = 0;
+const unsigned int BatteryImpl::s_CONVERSION_POLL_TIME = 1;
+const unsigned int BatteryImpl::s_CONVERSION_TIMEOUT = 1000;
 
 BatteryImpl::BatteryImpl(BatteryAdapter* adapter, BatteryThresholdConfig batteryThresholdConfig)
 : m_adapter(adapter)
 , m_evalFsm(new BatteryVoltageEvalFsm(this))
 , m_startupTimer(new SpinTimer(s_DEFAULT_STARTUP_TIME, new BattStartupTimerAction(this), SpinTimer::IS_NON_RECURRING, SpinTimer::IS_AUTOSTART))
-, m_pollTimer(new SpinTimer(s_DEFAULT_POLL_TIME, new BattStatusEvalTimerAction(this), SpinTimer::IS_RECURRING, SpinTimer::IS_NON_AUTOSTART))
-, m_evalStatusTimer(new SpinTimer(s_DEFAULT_ASYNC_STATUS_EVAL_TIME, m_pollTimer->action(), SpinTimer::IS_NON_RECURRING, SpinTimer::IS_NON_AUTOSTART))   // re-use the same BattStatusEvalTimerAdapter object
+, m_pollTimer(new SpinTimer(s_DEFAULT_POLL_TIME, new BattPollTimerAction(this), SpinTimer::IS_RECURRING, SpinTimer::IS_NON_AUTOSTART))
+, m_evalStatusTimer(new SpinTimer(s_DEFAULT_ASYNC_STATUS_EVAL_TIME, new BattStatusEvalTimerAction(this), SpinTimer::IS_NON_RECURRING, SpinTimer::IS_NON_AUTOSTART))
+, m_conversionTimer(new SpinTimer(s_CONVERSION_POLL_TIME, new BattConversionTimerAction(this), SpinTimer::IS_RECURRING, SpinTimer::IS_NON_AUTOSTART))
 , m_batteryVoltage(0.0)
 , m_battVoltageSenseFactor(2.0)
-, m_battWarnThreshd(batteryThresholdConfig.battWarnThreshd)
-, m_battStopThrshd(batteryThresholdConfig.battStopThrshd)
-, m_battShutThrshd(batteryThresholdConfig.battShutThrshd)
-, m_battHyst(batteryThresholdConfig.battHyst)
-{ }
+, m_battVoltageConvCoeff(0.0)
+, m_sampleFilter()
+, m_isAdaptivePolling(false)
+, m_minPollTime(Battery::s_MIN_POLL_TIME)
+, m_maxPollTime(Battery::s_MAX_POLL_TIME)
+, m_pollDistanceSpan(Battery::s_POLL_DISTANCE_SPAN)
+, m_pollTime(s_DEFAULT_POLL_TIME)
+, m_previousBatteryVoltage(0.0)
+, m_previousBatteryMillis(0)
+, m_isPreviousBatteryVoltageValid(false)
+, m_isFastTransitions(false)
+, m_dropRateLimit(Battery::s_DROP_RATE_LIMIT)
+, m_numConfirmations(Battery::s_NUM_CONFIRMATIONS)
+, m_confirmationsLeft(0)
+, m_dropRateVoltage(0.0)
+, m_dropRateMillis(0)
+, m_isDropRateValid(false)
+, m_isOcvEstimation(false)
+, m_isOcvCurrent(false)
+, m_ocvEstimator()
+, m_isTrendPrediction(false)
+, m_voltageTrend()
+, m_predictionHorizon(Battery::s_PREDICTION_HORIZON)
+, m_isShutdownPredicted(false)
+, m_timeToWarn(BatteryVoltageTrend::s_TIME_UNKNOWN)
+, m_timeToStop(BatteryVoltageTrend::s_TIME_UNKNOWN)
+, m_timeToShutdown(BatteryVoltageTrend::s_TIME_UNKNOWN)
+, m_isPushMode(false)
+, m_sampleQueue()
+, m_sampleSequence(0)
+, m_timestampMillis(0)
+, m_rawBattSenseValue(0.0)
+, m_rawBattSenseCount(0)
+, m_rawBattSenseConvCoeff(0.0)
+, m_isIntegerEvaluation(false)
+, m_isBatteryVoltageValid(true)
+, m_isStateOfCharge(false)
+, m_stateOfCharge()
+, m_coulombCounter()
+, m_numCells(0)
+, m_numCellChannels(0)
+, m_cellVoltageConvCoeff(0.0)
+, m_minCellVoltage(0.0)
+, m_maxCellVoltage(0.0)
+, m_evaluationVoltage(0.0)
+, m_cellImbalanceThreshold(Battery::s_CELL_IMBALANCE_THRSHD)
+, m_isCellImbalance(false)
+, m_statusSeqlock()
+, m_isStatusPublished(false)
+, m_telemetryRecorder(0)
+, m_telemetryChannel(0)
+, m_isConversionPending(false)
+, m_isConversionNotified(0)
+, m_conversionNumCells(0)
+, m_conversionStartMillis(0)
+, m_thresholdConfig()
+#if BATTERY_METRICS_ENABLED
+, m_metrics()
+, m_sampleStartMicros(0)
+#endif
+{
+  m_thresholdConfig.publish(batteryThresholdConfig);
+  updateBattVoltageConvCoeff();
+}
 
 BatteryImpl::~BatteryImpl()
 {
-  delete m_evalStatusTimer;
-  m_evalStatusTimer = 0;
+  delete m_conversionTimer->action();
+  delete m_conversionTimer; m_conversionTimer = 0;
+
+  delete m_evalStatusTimer->action();
+  delete m_evalStatusTimer; m_evalStatusTimer = 0;
 
   delete m_pollTimer->action();
   delete m_pollTimer; m_pollTimer = 0;
@@ -102,20 +212,264 @@ BatteryAdapter* BatteryImpl::adapter()
 
 void BatteryImpl::startup()
 {
-  if (0 != m_adapter)
-  {
-    m_battVoltageSenseFactor = m_adapter->readBattVoltageSenseFactor();
-  }
+  battVoltageSensFactorChanged();
   evaluateStatusAsync();
-  m_pollTimer->start(s_DEFAULT_POLL_TIME);
+  m_pollTimer->start(m_pollTime);
 }
 
 void BatteryImpl::evaluateStatus()
 {
   if ((0 != m_adapter) && (0 != m_evalFsm))
   {
-    m_batteryVoltage = m_adapter->readRawBattSenseValue() * m_battVoltageSenseFactor * adapter()->getVAdcFullrange() / (adapter()->getNAdcFullrange() + 1);
-    m_evalFsm->evaluateStatus();
+    if (m_isPushMode)
+    {
+      drainSamples();
+    }
+    else
+    {
+      processSample(numCellChannels(), false);
+    }
+  }
+}
+
+unsigned int BatteryImpl::numCellChannels()
+{
+  return m_numCellChannels;
+}
+
+void BatteryImpl::processSample(unsigned int numCells, bool isConverted)
+{
+#if BATTERY_METRICS_ENABLED
+  // one time line per sample: the ADC read and the evaluation are both measured from this start
+  m_sampleStartMicros = m_adapter->getUptimeMicros();
+#endif
+  bool isAcquired = (0 == numCells) ? acquireBattSenseValue(isConverted) : acquireCellSenseValues(numCells);
+  if (isAcquired)
+  {
+    evaluateSample();
+#if BATTERY_METRICS_ENABLED
+    m_metrics.recordEvaluation(m_adapter->getUptimeMicros() - m_sampleStartMicros);
+#endif
+  }
+}
+
+void BatteryImpl::drainSamples()
+{
+  BatteryRawSample sample;
+  // bounded batch, samples pushed meanwhile are taken by the next drain
+  for (unsigned int i = 0; (i < BatterySampleQueue::s_CAPACITY) && m_sampleQueue.pop(sample); i++)
+  {
+#if BATTERY_METRICS_ENABLED
+    unsigned long startMicros = m_adapter->getUptimeMicros();
+#endif
+    if (acceptBattSenseValues(&sample.rawBattSenseValue, 1, sample.timestampMillis))
+    {
+      evaluateSample();
+#if BATTERY_METRICS_ENABLED
+      m_metrics.recordEvaluation(m_adapter->getUptimeMicros() - startMicros);
+#endif
+    }
+  }
+}
+
+void BatteryImpl::evaluateSample()
+{
+  float battCurrent = 0.0;
+  bool isCurrent = m_adapter->readBattCurrent(battCurrent);
+  m_isOcvCurrent = isCurrent;
+  if (isCurrent)
+  {
+    m_coulombCounter.update(getBatteryVoltage(), battCurrent, m_timestampMillis);
+  }
+  if (m_isOcvEstimation)
+  {
+    m_ocvEstimator.update(sensedEvaluationVoltage(), isCurrent ? battCurrent : 0.0, m_timestampMillis);
+  }
+  if (m_isStateOfCharge)
+  {
+    // the OCV curves hold for the unloaded voltage, prefer the estimate over the voltage sagging under load
+    m_stateOfCharge.update(isOcvAvailable() ? m_ocvEstimator.ocv() : getBatteryVoltage(), m_timestampMillis);
+  }
+  if (m_isTrendPrediction)
+  {
+    evaluateTrend();
+  }
+  m_isStatusPublished = false;
+  m_evalFsm->evaluateStatus();
+  if (!m_isStatusPublished)
+  {
+    // no state entry has published this sample yet
+    publishStatus();
+  }
+  if (0 != m_numCells)
+  {
+    evaluateCellImbalance();
+  }
+  if (m_isTrendPrediction)
+  {
+    evaluateShutdownPrediction();
+  }
+  if (m_isFastTransitions)
+  {
+    evaluateDropRate();
+  }
+  if (0 != m_telemetryRecorder)
+  {
+    recordTelemetry();
+  }
+  if (m_isAdaptivePolling && !m_isPushMode)
+  {
+    updatePollTime();
+  }
+}
+
+void BatteryImpl::startEvaluation()
+{
+  if ((0 == m_adapter) || (0 == m_evalFsm) || m_isConversionPending)
+  {
+    return;
+  }
+  if (m_isPushMode)
+  {
+    drainSamples();
+    return;
+  }
+  unsigned int numCells = numCellChannels();
+  BatteryAtomic::store(&m_isConversionNotified, 0);
+  if (m_adapter->startConversion((0 == numCells) ? m_sampleFilter.oversampling() : numCells))
+  {
+    m_isConversionPending = true;
+    m_conversionNumCells = numCells;
+    m_conversionStartMillis = m_adapter->getUptimeMillis();
+    m_conversionTimer->start(s_CONVERSION_POLL_TIME);
+  }
+  else
+  {
+    processSample(numCells, false);
+  }
+}
+
+void BatteryImpl::conversionTimerExpired()
+{
+  if (!m_isConversionPending || (0 == m_adapter))
+  {
+    m_conversionTimer->cancel();
+    return;
+  }
+  if ((0 != BatteryAtomic::loadAcquire(&m_isConversionNotified)) || m_adapter->isConversionComplete())
+  {
+    m_conversionTimer->cancel();
+    m_isConversionPending = false;
+    processSample(m_conversionNumCells, true);
+  }
+  else if (m_adapter->getUptimeMillis() - m_conversionStartMillis >= s_CONVERSION_TIMEOUT)
+  {
+    // conversion lost, drop the sample, the next poll starts a new one
+    m_conversionTimer->cancel();
+    m_isConversionPending = false;
+  }
+}
+
+void BatteryImpl::conversionComplete()
+{
+  BatteryAtomic::storeRelease(&m_isConversionNotified, 1);
+}
+
+bool BatteryImpl::acquireBattSenseValue(bool isConverted)
+{
+  unsigned int rawSamples[BatterySampleFilter::s_MAX_OVERSAMPLING];
+  unsigned int numSamples = 1;
+  if ((1 == m_sampleFilter.oversampling()) && !isConverted)
+  {
+    rawSamples[0] = m_adapter->readRawBattSenseValue();
+  }
+  else
+  {
+    numSamples = m_adapter->readRawBattSenseValues(rawSamples, m_sampleFilter.oversampling());
+  }
+#if BATTERY_METRICS_ENABLED
+  m_metrics.recordAdcRead(m_adapter->getUptimeMicros() - m_sampleStartMicros);
+#endif
+  return acceptBattSenseValues(rawSamples, numSamples, m_adapter->getUptimeMillis());
+}
+
+bool BatteryImpl::acceptBattSenseValues(const unsigned int* rawSamples, unsigned int numSamples, unsigned long timestampMillis)
+{
+  if (0 == numSamples)
+  {
+    return false;
+  }
+  m_timestampMillis = timestampMillis;
+  m_sampleSequence++;
+  m_numCells = 0;
+  m_rawBattSenseConvCoeff = m_battVoltageConvCoeff;
+  if ((1 == numSamples) && (BattFilterNone == m_sampleFilter.mode()))
+  {
+    // no filter stage, stay in the integer domain
+    m_rawBattSenseCount = rawSamples[0];
+    m_rawBattSenseValue = rawSamples[0];
+  }
+  else
+  {
+    m_rawBattSenseValue = m_sampleFilter.filter(BatterySampleFilter::decimate(rawSamples, numSamples));
+    m_rawBattSenseCount = static_cast<unsigned int>(m_rawBattSenseValue + 0.5);
+  }
+  if (m_isIntegerEvaluation)
+  {
+    m_isBatteryVoltageValid = false;   // computed on demand by getBatteryVoltage()
+  }
+  else
+  {
+    m_batteryVoltage = BatteryVoltageConverter::convert(m_rawBattSenseValue, m_battVoltageConvCoeff);
+    m_isBatteryVoltageValid = true;
+  }
+  return true;
+}
+
+bool BatteryImpl::acquireCellSenseValues(unsigned int numCells)
+{
+  unsigned int rawCells[Battery::s_MAX_NUM_CELLS];
+  unsigned int numRead = m_adapter->readRawCellSenseValues(rawCells, numCells);
+#if BATTERY_METRICS_ENABLED
+  m_metrics.recordAdcRead(m_adapter->getUptimeMicros() - m_sampleStartMicros);
+#endif
+  if (numRead < numCells)
+  {
+    return false;
+  }
+  m_timestampMillis = m_adapter->getUptimeMillis();
+  m_sampleSequence++;
+  m_numCells = numCells;
+
+  unsigned int minRaw;
+  unsigned int maxRaw;
+  unsigned int sumRaw;
+  BatteryVoltageConverter::statistics(rawCells, numCells, minRaw, maxRaw, sumRaw);
+  m_rawBattSenseCount = sumRaw;
+  m_rawBattSenseValue = sumRaw;
+  m_rawBattSenseConvCoeff = m_cellVoltageConvCoeff;
+  m_batteryVoltage = BatteryVoltageConverter::convert(sumRaw, m_cellVoltageConvCoeff);
+  m_isBatteryVoltageValid = true;
+  m_minCellVoltage = BatteryVoltageConverter::convert(minRaw, m_cellVoltageConvCoeff);
+  m_maxCellVoltage = BatteryVoltageConverter::convert(maxRaw, m_cellVoltageConvCoeff);
+  m_evaluationVoltage = m_minCellVoltage * numCells;
+  return true;
+}
+
+void BatteryImpl::evaluateCellImbalance()
+{
+  float cellImbalance = m_maxCellVoltage - m_minCellVoltage;
+  if (cellImbalance > m_cellImbalanceThreshold)
+  {
+    if (!m_isCellImbalance)
+    {
+      m_isCellImbalance = true;
+      m_adapter->notifyBattCellImbalance(cellImbalance);
+    }
+  }
+  else
+  {
+    m_isCellImbalance = false;
   }
 }
 
@@ -124,19 +478,110 @@ void BatteryImpl::evaluateStatusAsync()
   m_evalStatusTimer->start(s_DEFAULT_ASYNC_STATUS_EVAL_TIME);
 }
 
+void BatteryImpl::pollTimerExpired()
+{
+#if BATTERY_METRICS_ENABLED
+  unsigned long nowMicros = (0 != m_adapter) ? m_adapter->getUptimeMicros() : 0;
+  startEvaluation();
+  m_metrics.recordPoll(nowMicros, m_pollTime);   // poll time as re-started by adaptive polling, if evaluated synchronously
+#else
+  startEvaluation();
+#endif
+}
+
 void BatteryImpl::battVoltageSensFactorChanged()
 {
   if (0 != m_adapter)
   {
     m_battVoltageSenseFactor = m_adapter->readBattVoltageSenseFactor();
   }
+  updateBattVoltageConvCoeff();
+}
+
+void BatteryImpl::updateBattVoltageConvCoeff()
+{
+  if (0 != m_adapter)
+  {
+    m_battVoltageConvCoeff = BatteryVoltageConverter::conversionCoefficient(m_battVoltageSenseFactor, m_adapter->getVAdcFullrange(), m_adapter->getNAdcFullrange());
+    m_cellVoltageConvCoeff = BatteryVoltageConverter::conversionCoefficient(m_adapter->readCellVoltageSenseFactor(), m_adapter->getVAdcFullrange(), m_adapter->getNAdcFullrange());
+    m_rawBattSenseConvCoeff = (0 != m_numCells) ? m_cellVoltageConvCoeff : m_battVoltageConvCoeff;
+    m_isBatteryVoltageValid = false;
+    unsigned int numCells = m_adapter->getNumCells();
+    m_numCellChannels = (numCells > Battery::s_MAX_NUM_CELLS) ? Battery::s_MAX_NUM_CELLS : numCells;
+  }
+  if (0 != m_evalFsm)
+  {
+    m_evalFsm->updateThresholdLevels();
+  }
 }
 
 float BatteryImpl::getBatteryVoltage()
 {
+  if (!m_isBatteryVoltageValid)
+  {
+    m_batteryVoltage = BatteryVoltageConverter::convert(m_rawBattSenseCount, m_rawBattSenseConvCoeff);
+    m_isBatteryVoltageValid = true;
+  }
   return m_batteryVoltage;
 }
 
+void BatteryImpl::getStatusSnapshot(BatteryStatusSnapshot& snapshot)
+{
+  m_statusSeqlock.read(snapshot);
+  if (snapshot.isVoltageDeferred)
+  {
+    snapshot.batteryVoltage = BatteryVoltageConverter::convert(snapshot.rawBattSenseValue, snapshot.battVoltageConvCoeff);
+    snapshot.isVoltageDeferred = false;
+  }
+}
+
+void BatteryImpl::publishStatus()
+{
+  BatteryStatusSnapshot snapshot;   // every field is assigned, no clearing
+  snapshot.isVoltageDeferred = !m_isBatteryVoltageValid;
+  snapshot.batteryVoltage = m_isBatteryVoltageValid ? m_batteryVoltage : 0.0;
+  snapshot.rawBattSenseValue = m_rawBattSenseCount;
+  snapshot.battVoltageConvCoeff = m_rawBattSenseConvCoeff;
+  snapshot.state = m_evalFsm->state()->id();
+  snapshot.previousState = m_evalFsm->previousState()->id();
+  snapshot.sampleSequence = m_sampleSequence;
+  snapshot.timestampMillis = m_timestampMillis;
+  snapshot.stateOfCharge = m_isStateOfCharge ? m_stateOfCharge.stateOfCharge() : 0.0;
+  snapshot.timeToEmpty = m_isStateOfCharge ? m_stateOfCharge.timeToEmpty() : BatteryStateOfCharge::s_TIME_TO_EMPTY_UNKNOWN;
+  snapshot.numCells = m_numCells;
+  snapshot.minCellVoltage = m_minCellVoltage;
+  snapshot.maxCellVoltage = m_maxCellVoltage;
+  snapshot.timeToWarn = m_timeToWarn;
+  snapshot.timeToStop = m_timeToStop;
+  snapshot.timeToShutdown = m_timeToShutdown;
+  snapshot.openCircuitVoltage = m_isOcvEstimation ? m_ocvEstimator.ocv() : 0.0;
+  snapshot.internalResistance = m_isOcvEstimation ? m_ocvEstimator.internalResistance() : 0.0;
+  snapshot.battCurrent = m_coulombCounter.battCurrent();
+  snapshot.consumedCharge = m_coulombCounter.consumedCharge();
+  snapshot.consumedEnergy = m_coulombCounter.consumedEnergy();
+  m_statusSeqlock.publish(snapshot);
+  m_isStatusPublished = true;
+}
+
+void BatteryImpl::attachTelemetryRecorder(BatteryTelemetryRecorder* recorder, unsigned long channel)
+{
+  m_telemetryRecorder = recorder;
+  m_telemetryChannel = channel;
+}
+
+void BatteryImpl::recordTelemetry()
+{
+  BatteryTelemetryRecord record;
+  record.timestampMillis = static_cast<uint64_t>(m_timestampMillis);
+  record.rawBattSenseValue = static_cast<uint16_t>(m_rawBattSenseCount);
+  record.state = static_cast<uint8_t>(m_evalFsm->state()->id());
+  record.reserved = 0;
+  record.padding = 0;
+  record.batteryVoltage = getBatteryVoltage();
+  record.channel = static_cast<uint32_t>(m_telemetryChannel);
+  m_telemetryRecorder->record(record);
+}
+
 bool BatteryImpl::isBattVoltageOk()
 {
   bool isVoltageOk = false;
@@ -195,22 +640,315 @@ const char* BatteryImpl::getPreviousStateName()
   return m_evalFsm->previousState()->toString();
 }
 
-float BatteryImpl::battWarnThreshd()
+void BatteryImpl::configureSampleFilter(BattSampleFilterMode mode, unsigned int oversampling, unsigned int windowSize, float alpha)
+{
+  m_sampleFilter.configure(mode, oversampling, windowSize, alpha);
+}
+
+void BatteryImpl::configureAdaptivePolling(bool isAdaptive, unsigned int minPollTime, unsigned int maxPollTime, float distanceSpan)
+{
+  m_isAdaptivePolling = isAdaptive;
+  m_minPollTime = (minPollTime < 1) ? 1 : minPollTime;
+  m_maxPollTime = (maxPollTime < m_minPollTime) ? m_minPollTime : maxPollTime;
+  m_pollDistanceSpan = (distanceSpan > 0.0) ? distanceSpan : Battery::s_POLL_DISTANCE_SPAN;
+  m_isPreviousBatteryVoltageValid = false;
+  if (!m_isAdaptivePolling && (s_DEFAULT_POLL_TIME != m_pollTime))
+  {
+    m_pollTime = s_DEFAULT_POLL_TIME;
+    if (m_pollTimer->isRunning())
+    {
+      m_pollTimer->start(m_pollTime);
+    }
+  }
+}
+
+void BatteryImpl::configureFastTransitions(bool isEnabled, float dropRateLimit, unsigned int numConfirmations)
+{
+  m_isFastTransitions = isEnabled;
+  m_dropRateLimit = (dropRateLimit > 0.0) ? dropRateLimit : Battery::s_DROP_RATE_LIMIT;
+  m_numConfirmations = numConfirmations;
+  m_confirmationsLeft = 0;
+  m_isDropRateValid = false;
+  m_evalFsm->setMultiLevelTransitions(isEnabled);
+}
+
+void BatteryImpl::configureOcvEstimation(bool isEnabled, float initialResistance, float voltageNoise, float ocvDrift)
+{
+  m_isOcvEstimation = isEnabled;
+  m_ocvEstimator.configure(initialResistance, voltageNoise, ocvDrift);
+}
+
+void BatteryImpl::configureTrendPrediction(bool isEnabled, unsigned int windowSize, float predictionHorizon)
+{
+  m_isTrendPrediction = isEnabled;
+  m_voltageTrend.configure(windowSize);
+  m_predictionHorizon = (predictionHorizon > 0.0) ? predictionHorizon : Battery::s_PREDICTION_HORIZON;
+  m_isShutdownPredicted = false;
+  m_timeToWarn = BatteryVoltageTrend::s_TIME_UNKNOWN;
+  m_timeToStop = BatteryVoltageTrend::s_TIME_UNKNOWN;
+  m_timeToShutdown = BatteryVoltageTrend::s_TIME_UNKNOWN;
+}
+
+void BatteryImpl::evaluateTrend()
+{
+  const float* levels = m_evalFsm->thresholdLevels();
+  m_voltageTrend.update(evaluationVoltage(), m_timestampMillis);
+  m_timeToWarn = m_voltageTrend.timeToLevel(levels[BattLevelWarn]);
+  m_timeToStop = m_voltageTrend.timeToLevel(levels[BattLevelStop]);
+  m_timeToShutdown = m_voltageTrend.timeToLevel(levels[BattLevelShut]);
+}
+
+void BatteryImpl::evaluateShutdownPrediction()
+{
+  bool isPredicted = (m_timeToShutdown >= 0.0) && (m_timeToShutdown <= m_predictionHorizon);
+  if (isPredicted)
+  {
+    if (!m_isShutdownPredicted && !m_evalFsm->isBattVoltageBelowShutdownThreshold())
+    {
+      m_isShutdownPredicted = true;
+      m_adapter->notifyBattShutdownPredicted(m_timeToShutdown);
+    }
+  }
+  else
+  {
+    m_isShutdownPredicted = false;
+  }
+}
+
+void BatteryImpl::configurePushMode(bool isPushMode, unsigned int drainTime)
+{
+  m_isPushMode = isPushMode;
+  m_pollTime = isPushMode ? ((drainTime < 1) ? 1 : drainTime) : s_DEFAULT_POLL_TIME;
+  if (m_pollTimer->isRunning())
+  {
+    m_pollTimer->start(m_pollTime);
+  }
+}
+
+bool BatteryImpl::pushRawSample(unsigned int rawBattSenseValue, unsigned long timestampMillis)
+{
+  return m_sampleQueue.push(rawBattSenseValue, timestampMillis);
+}
+
+unsigned long BatteryImpl::numRejectedSamples()
+{
+  return m_sampleQueue.numRejected();
+}
+
+void BatteryImpl::evaluateDropRate()
+{
+  float voltage = evaluationVoltage();
+  if (m_confirmationsLeft > 0)
+  {
+    m_confirmationsLeft--;
+  }
+  else if (m_isDropRateValid && (m_timestampMillis != m_dropRateMillis))
+  {
+    float dropRate = (m_dropRateVoltage - voltage) * 1000.0 / (m_timestampMillis - m_dropRateMillis);   // [V/s]
+    if (dropRate > m_dropRateLimit)
+    {
+      m_confirmationsLeft = m_numConfirmations;
+    }
+  }
+  m_dropRateVoltage = voltage;
+  m_dropRateMillis = m_timestampMillis;
+  m_isDropRateValid = true;
+  if (m_confirmationsLeft > 0)
+  {
+    // confirm the collapse right away instead of waiting for the next polls
+    evaluateStatusAsync();
+  }
+}
+
+unsigned int BatteryImpl::pollTime()
+{
+  return m_pollTime;
+}
+
+void BatteryImpl::updatePollTime()
+{
+  float batteryVoltage = evaluationVoltage();
+  const float* levels = m_evalFsm->thresholdLevels();
+  float distance = m_pollDistanceSpan;       // to the nearest level, either side
+  float distanceBelow = -1.0;                // to the nearest level below the current voltage, -1: none
+  for (unsigned int i = 0; i < BattLevelAlways; i++)
+  {
+    float delta = batteryVoltage - levels[i];
+    float absDelta = (delta < 0.0) ? -delta : delta;
+    if (absDelta < distance)
+    {
+      distance = absDelta;
+    }
+    if ((delta >= 0.0) && ((distanceBelow < 0.0) || (delta < distanceBelow)))
+    {
+      distanceBelow = delta;
+    }
+  }
+
+  // sparse when far from any level, dense when close to one
+  float pollTime = m_minPollTime + (m_maxPollTime - m_minPollTime) * (distance / m_pollDistanceSpan);
+
+  // falling: poll at least twice before the next level below is projected to be reached
+  if (m_isPreviousBatteryVoltageValid && (m_timestampMillis != m_previousBatteryMillis) && (batteryVoltage < m_previousBatteryVoltage) && (distanceBelow >= 0.0))
+  {
+    float fallRate = (m_previousBatteryVoltage - batteryVoltage) / (m_timestampMillis - m_previousBatteryMillis);   // [V/ms]
+    float timeToLevel = distanceBelow / fallRate;
+    if (timeToLevel / 2 < pollTime)
+    {
+      pollTime = timeToLevel / 2;
+    }
+  }
+
+  unsigned int nextPollTime = (pollTime < m_minPollTime) ? m_minPollTime : ((pollTime > m_maxPollTime) ? m_maxPollTime : static_cast<unsigned int>(pollTime));
+  if ((nextPollTime != m_pollTime) && m_pollTimer->isRunning())
+  {
+    m_pollTime = nextPollTime;
+    m_pollTimer->start(m_pollTime);
+  }
+  m_previousBatteryVoltage = batteryVoltage;
+  m_previousBatteryMillis = m_timestampMillis;
+  m_isPreviousBatteryVoltageValid = true;
+}
+
+void BatteryImpl::resetConsumption()
+{
+  m_coulombCounter.reset();
+  publishStatus();
+}
+
+void BatteryImpl::configureStateOfCharge(bool isEnabled, BattChemistry chemistry, unsigned int numCells)
+{
+  m_isStateOfCharge = isEnabled;
+  m_stateOfCharge.configure(chemistry, numCells);
+}
+
+void BatteryImpl::configureTransitionQualification(BatteryQualificationConfig qualificationConfig)
+{
+  if (0 != m_evalFsm)
+  {
+    m_evalFsm->configureQualification(qualificationConfig);
+  }
+}
+
+unsigned long BatteryImpl::timestampMillis()
+{
+  return m_timestampMillis;
+}
+
+unsigned long BatteryImpl::sampleSequence()
+{
+  return m_sampleSequence;
+}
+
+const BatteryTransitionHistory* BatteryImpl::transitionHistory()
+{
+  return (0 != m_evalFsm) ? &m_evalFsm->transitionHistory() : 0;
+}
+
+bool BatteryImpl::getMetrics(BatteryMetrics& metrics)
+{
+#if BATTERY_METRICS_ENABLED
+  m_metrics.read(metrics, m_timestampMillis);
+  return true;
+#else
+  memset(&metrics, 0, sizeof(metrics));
+  return false;
+#endif
+}
+
+void BatteryImpl::resetMetrics()
+{
+#if BATTERY_METRICS_ENABLED
+  m_metrics.reset();
+#endif
+}
+
+void BatteryImpl::recordStateEntry(BattVoltageEvalStateId state)
+{
+#if BATTERY_METRICS_ENABLED
+  m_metrics.recordStateEntry(state, m_timestampMillis);
+#endif
+}
+
+void BatteryImpl::setIntegerEvaluation(bool isIntegerEvaluation)
+{
+  m_isIntegerEvaluation = isIntegerEvaluation;
+  if (0 != m_evalFsm)
+  {
+    m_evalFsm->setIntegerEvaluation(isIntegerEvaluation);
+  }
+}
+
+bool BatteryImpl::isPackMode()
+{
+  return (0 != m_numCells);
+}
+
+bool BatteryImpl::isRawEvaluation()
 {
-  return m_battWarnThreshd;
+  return (0 == m_numCells) && !m_isOcvEstimation;
 }
 
-float BatteryImpl::battStopThrshd()
+float BatteryImpl::evaluationVoltage()
 {
-  return m_battStopThrshd;
+  return isOcvAvailable() ? m_ocvEstimator.ocv() : sensedEvaluationVoltage();
+}
+
+bool BatteryImpl::isOcvAvailable()
+{
+  return m_isOcvEstimation && m_isOcvCurrent && m_ocvEstimator.isValid();
+}
+
+float BatteryImpl::sensedEvaluationVoltage()
+{
+  return (0 != m_numCells) ? m_evaluationVoltage : getBatteryVoltage();
+}
+
+void BatteryImpl::setCellImbalanceThreshold(float cellImbalanceThreshold)
+{
+  m_cellImbalanceThreshold = cellImbalanceThreshold;
+}
+
+bool BatteryImpl::isIntegerEvaluation()
+{
+  return m_isIntegerEvaluation;
+}
+
+unsigned int BatteryImpl::rawBattSenseValue()
+{
+  return m_rawBattSenseCount;
+}
+
+float BatteryImpl::battVoltageConvCoeff()
+{
+  return m_battVoltageConvCoeff;
+}
+
+void BatteryImpl::setTableEvalEngine(bool isTableEngine)
+{
+  if (0 != m_evalFsm)
+  {
+    m_evalFsm->setTableEngine(isTableEngine);
+  }
+}
+
+bool BatteryImpl::setThresholdConfig(BatteryThresholdConfig batteryThresholdConfig)
+{
+  bool isValid = Battery::isValidThresholdConfig(batteryThresholdConfig);
+  if (isValid)
+  {
+    // picked up by the BatteryVoltageEvalFsm with the next evaluation
+    m_thresholdConfig.publish(batteryThresholdConfig);
+  }
+  return isValid;
 }
 
-float BatteryImpl::battShutThrshd()
+unsigned long BatteryImpl::getThresholdConfig(BatteryThresholdConfig& batteryThresholdConfig)
 {
-  return m_battShutThrshd;
+  return m_thresholdConfig.read(batteryThresholdConfig);
 }
 
-float BatteryImpl::battHyst()
+unsigned long BatteryImpl::thresholdGeneration()
 {
-  return m_battHyst;
+  return m_thresholdConfig.generation();
 }
@@ -9,8 +9,15 @@
 #define BATTERYIMPL_H_
 
 #include "Battery.h"
+#include "BatterySampleFilter.h"
+#include "BatteryStateOfCharge.h"
+#include "BatteryCoulombCounter.h"
+#include "BatterySeqlock.h"
+#include "BatteryMetrics.h"
+#include "BatterySampleQueue.h"
 
 class SpinTimer;
+class BatteryTelemetryRecorder;
 class BatteryAdapter;
 class BatteryVoltageEvalFsm;
 
@@ -55,6 +62,27 @@ public:
    */
   void evaluateStatusAsync();
 
+  /**
+   * Poll timer expired: evaluate and record the poll jitter.
+   */
+  void pollTimerExpired();
+
+  /**
+   * Timer driven evaluation: start a split-phase conversion if the adapter supports it, otherwise evaluate synchronously.
+   * Skipped while a previous conversion is still pending.
+   */
+  void startEvaluation();
+
+  /**
+   * Conversion timer expired: evaluate the pending conversion's results once complete, drop it on timeout.
+   */
+  void conversionTimerExpired();
+
+  /**
+   * Notify the pending conversion has completed, see Battery::conversionComplete(). Interrupt safe.
+   */
+  void conversionComplete();
+
   /**
    * Notify Battery Voltage Sense Factor has changed in the Inventory Management Data.
    * The Battery component shall read the new value and adjust the signal conversion accordingly.
@@ -67,6 +95,11 @@ public:
    */
   float getBatteryVoltage();
 
+  /**
+   * Get a consistent snapshot of the status published by the latest evaluation, lock-free.
+   */
+  void getStatusSnapshot(BatteryStatusSnapshot& snapshot);
+
   /**
    * Check if the currently measured Battery Voltage is ok.
    * @return true, if voltage is above the warning threshold level, false otherwise.
@@ -94,10 +127,262 @@ public:
   const char* getCurrentStateName();
   const char* getPreviousStateName();
 
-  float battWarnThreshd();           /// Battery Voltage Warn Threshold [V]
-  float battStopThrshd();            /// Battery Voltage Stop Actors Threshold[V]
-  float battShutThrshd();            /// Battery Voltage Shutdown Threshold[V]
-  float battHyst();                  /// Battery Voltage Hysteresis around Threshold levels[V]
+  /**
+   * Configure the raw sample filter stage, see BatterySampleFilter::configure().
+   */
+  void configureSampleFilter(BattSampleFilterMode mode, unsigned int oversampling, unsigned int windowSize, float alpha);
+
+  /**
+   * Configure adaptive polling, see Battery::configureAdaptivePolling().
+   */
+  void configureAdaptivePolling(bool isAdaptive, unsigned int minPollTime, unsigned int maxPollTime, float distanceSpan);
+
+  /**
+   * Configure the fast transition path, see Battery::configureFastTransitions().
+   */
+  void configureFastTransitions(bool isEnabled, float dropRateLimit, unsigned int numConfirmations);
+
+  /**
+   * Configure the open circuit voltage estimator, see Battery::configureOcvEstimation().
+   */
+  void configureOcvEstimation(bool isEnabled, float initialResistance, float voltageNoise, float ocvDrift);
+
+  /**
+   * Configure the threshold crossing prediction, see Battery::configureTrendPrediction().
+   */
+  void configureTrendPrediction(bool isEnabled, unsigned int windowSize, float predictionHorizon);
+
+  /**
+   * Configure push mode sample ingestion, see Battery::configurePushMode().
+   */
+  void configurePushMode(bool isPushMode, unsigned int drainTime);
+
+  /**
+   * Queue a raw sample for evaluation, wait-free, single producer, see Battery::pushRawSample().
+   */
+  bool pushRawSample(unsigned int rawBattSenseValue, unsigned long timestampMillis);
+
+  /**
+   * Number of pushed samples rejected because the queue was full.
+   */
+  unsigned long numRejectedSamples();
+
+  /**
+   * Current status poll interval.
+   * @return Poll interval [ms].
+   */
+  unsigned int pollTime();
+
+  /**
+   * Attach a telemetry recorder, receiving one record per evaluated sample.
+   * @param recorder Pointer to a BatteryTelemetryRecorder object, 0: none
+   * @param channel Channel number written to the records.
+   */
+  void attachTelemetryRecorder(BatteryTelemetryRecorder* recorder, unsigned long channel);
+
+  /**
+   * Restart the consumed charge and energy accounting, see Battery::resetConsumption().
+   */
+  void resetConsumption();
+
+  /**
+   * Configure the state of charge estimator, see Battery::configureStateOfCharge().
+   */
+  void configureStateOfCharge(bool isEnabled, BattChemistry chemistry, unsigned int numCells);
+
+  /**
+   * Configure transition qualification, see Battery::configureTransitionQualification().
+   */
+  void configureTransitionQualification(BatteryQualificationConfig qualificationConfig);
+
+  /**
+   * BatteryAdapter::getUptimeMillis() of the latest evaluation [ms].
+   */
+  unsigned long timestampMillis();
+
+  /**
+   * Number of evaluations so far, index of the latest sample.
+   */
+  unsigned long sampleSequence();
+
+  /**
+   * Latest Battery Voltage Evaluation State transitions, see Battery::getTransitionHistory().
+   */
+  const BatteryTransitionHistory* transitionHistory();
+
+  /**
+   * Copy the metrics, see Battery::getMetrics().
+   * @return false if compiled without BATTERY_METRICS_ENABLED.
+   */
+  bool getMetrics(BatteryMetrics& metrics);
+  void resetMetrics();
+
+  /**
+   * Count a state entry in the metrics, called by the BatteryVoltageEvalFsm.
+   */
+  void recordStateEntry(BattVoltageEvalStateId state);
+
+  /**
+   * Select integer domain evaluation, see Battery::setIntegerEvaluation().
+   */
+  void setIntegerEvaluation(bool isIntegerEvaluation);
+  bool isIntegerEvaluation();
+
+  /**
+   * (Filtered) raw ADC count of the latest evaluation, rounded.
+   */
+  unsigned int rawBattSenseValue();
+
+  /**
+   * Raw ADC count to Battery Voltage conversion coefficient [V].
+   */
+  float battVoltageConvCoeff();
+
+  /**
+   * Pack mode: the latest evaluation has read BatteryAdapter::getNumCells() cell channels.
+   */
+  bool isPackMode();
+
+  /**
+   * The evaluation voltage is the pack voltage channel's raw ADC count times the conversion coefficient,
+   * i.e. the BatteryVoltageEvalFsm may evaluate integer guards on rawBattSenseValue().
+   */
+  bool isRawEvaluation();
+
+  /**
+   * Voltage the BatteryVoltageEvalFsm compares against the thresholds [V]: the Battery Voltage, or in pack mode
+   * the weakest cell voltage times the number of cells (equivalent to per-cell thresholds of threshold / numCells);
+   * the estimated open circuit voltage of that if the OCV estimator is enabled.
+   */
+  float evaluationVoltage();
+
+  /**
+   * Set the pack mode cell imbalance threshold, see Battery::setCellImbalanceThreshold().
+   */
+  void setCellImbalanceThreshold(float cellImbalanceThreshold);
+
+  /**
+   * Select the Battery Voltage evaluation engine.
+   * @param isTableEngine true: table driven engine, false: state class engine (default)
+   */
+  void setTableEvalEngine(bool isTableEngine);
+
+  /**
+   * Validate and publish a new threshold configuration, see Battery::setThresholdConfig().
+   * @return true if the configuration has been accepted.
+   */
+  bool setThresholdConfig(BatteryThresholdConfig batteryThresholdConfig);
+
+  /**
+   * Read the current threshold configuration, lock-free.
+   * @return Generation of the configuration read, see thresholdGeneration().
+   */
+  unsigned long getThresholdConfig(BatteryThresholdConfig& batteryThresholdConfig);
+
+  /**
+   * Generation of the threshold configuration, changes with every accepted setThresholdConfig().
+   */
+  unsigned long thresholdGeneration();
+
+  /**
+   * Publish the status of the current evaluation to the concurrent readers.
+   * Also called by the BatteryVoltageEvalFsm right before a state's entry action, so notification handlers
+   * read the status of the sample that caused the transition; the evaluation then does not publish that sample again.
+   */
+  void publishStatus();
+
+private:
+  /**
+   * Number of cell channels reported by the adapter, limited to Battery::s_MAX_NUM_CELLS.
+   * Read along with the conversion coefficients, not per sample.
+   */
+  unsigned int numCellChannels();
+
+  /**
+   * Acquire one sample and run the evaluation pipeline on it.
+   * @param numCells Number of cell channels to be read, 0: pack voltage channel.
+   * @param isConverted The sample has been converted by a split-phase conversion, read its results only.
+   */
+  void processSample(unsigned int numCells, bool isConverted);
+
+  /**
+   * Push mode: evaluate the queued samples in order, at most one queue capacity per call.
+   */
+  void drainSamples();
+
+  /**
+   * Run the evaluation pipeline on the sample just acquired (estimators, FSM, publishing, polling).
+   */
+  void evaluateSample();
+
+  /**
+   * Acquire the pack voltage channel through the sample filter stage.
+   * @param isConverted Read the results of a completed split-phase conversion.
+   * @return false if no sample is available.
+   */
+  bool acquireBattSenseValue(bool isConverted);
+
+  /**
+   * Take raw pack voltage channel samples as the current sample, through the sample filter stage.
+   * @param rawSamples Raw ADC counts, decimated into one sample.
+   * @param numSamples Number of raw ADC counts.
+   * @param timestampMillis Acquisition time [ms].
+   * @return false if no sample is available.
+   */
+  bool acceptBattSenseValues(const unsigned int* rawSamples, unsigned int numSamples, unsigned long timestampMillis);
+
+  /**
+   * Pack mode: acquire all cell channels, derive the pack and the evaluation voltage.
+   * @return false if not all cell channels have been read.
+   */
+  bool acquireCellSenseValues(unsigned int numCells);
+
+  /**
+   * Pack mode: fire the cell imbalance notification on a rising edge of the cell voltage spread.
+   */
+  void evaluateCellImbalance();
+
+  /**
+   * Re-compute the combined conversion coefficient from the sense factor and the adapter's ADC full range.
+   */
+  void updateBattVoltageConvCoeff();
+
+  /**
+   * Adaptive polling: derive the next poll interval from the distance of the latest Battery Voltage
+   * to the nearest threshold level and from the falling rate since the previous poll.
+   */
+  void updatePollTime();
+
+  /**
+   * Fast transitions: start a burst of confirmation evaluations if the voltage drops faster than the limit.
+   */
+  void evaluateDropRate();
+
+  /**
+   * Measured voltage the evaluation is based on [V], see evaluationVoltage().
+   */
+  float sensedEvaluationVoltage();
+
+  /**
+   * The OCV estimator is enabled and has an estimate of the evaluation voltage's open circuit voltage,
+   * based on the current value of the latest sample.
+   */
+  bool isOcvAvailable();
+
+  /**
+   * Threshold crossing prediction: extrapolate the voltage trend to the threshold levels.
+   */
+  void evaluateTrend();
+
+  /**
+   * Threshold crossing prediction: fire the shutdown prediction notification on entering the horizon.
+   */
+  void evaluateShutdownPrediction();
+
+  /**
+   * Pass the evaluation just done to the attached telemetry recorder.
+   */
+  void recordTelemetry();
 
 private:
   BatteryAdapter* m_adapter;  /// Pointer to the currently attached specific BatteryAdapter object
@@ -105,21 +390,79 @@ private:
   SpinTimer* m_startupTimer;
   SpinTimer* m_pollTimer;
   SpinTimer* m_evalStatusTimer;
+  SpinTimer* m_conversionTimer;
 
   float m_batteryVoltage;
   float m_battVoltageSenseFactor;
+  float m_battVoltageConvCoeff;      /// combined raw count to Battery Voltage conversion coefficient [V]
+  BatterySampleFilter m_sampleFilter;
 
+  bool m_isAdaptivePolling;
+  unsigned int m_minPollTime;        /// adaptive polling: shortest poll interval [ms]
+  unsigned int m_maxPollTime;        /// adaptive polling: longest poll interval [ms]
+  float m_pollDistanceSpan;          /// adaptive polling: threshold distance from which on the longest interval applies [V]
+  unsigned int m_pollTime;           /// current poll interval [ms]
+  float m_previousBatteryVoltage;    /// Battery Voltage of the previous evaluation [V]
+  unsigned long m_previousBatteryMillis;  /// timestamp of the previous evaluation [ms]
+  bool m_isPreviousBatteryVoltageValid;
+  bool m_isFastTransitions;          /// multi-level transitions and confirmation bursts enabled
+  float m_dropRateLimit;             /// fast transitions: confirmation burst drop rate limit [V/s]
+  unsigned int m_numConfirmations;   /// fast transitions: confirmation evaluations per burst
+  unsigned int m_confirmationsLeft;  /// fast transitions: confirmation evaluations still to come in the current burst
+  float m_dropRateVoltage;           /// fast transitions: evaluation voltage of the previous evaluation [V]
+  unsigned long m_dropRateMillis;    /// fast transitions: timestamp of the previous evaluation [ms]
+  bool m_isDropRateValid;            /// fast transitions: m_dropRateVoltage and m_dropRateMillis are valid
+  bool m_isOcvEstimation;            /// evaluate the estimated open circuit voltage
+  bool m_isOcvCurrent;               /// the latest sample has a current value, i.e. the OCV estimate separates the load sag
+  BatteryOcvEstimator m_ocvEstimator;
+  bool m_isTrendPrediction;          /// threshold crossing prediction enabled
+  BatteryVoltageTrend m_voltageTrend;
+  float m_predictionHorizon;         /// trend prediction: shutdown prediction notification lead time [s]
+  bool m_isShutdownPredicted;        /// trend prediction: notification fired, not yet re-armed
+  float m_timeToWarn;                /// trend prediction: predicted time to the warn threshold [s]
+  float m_timeToStop;                /// trend prediction: predicted time to the stop threshold [s]
+  float m_timeToShutdown;            /// trend prediction: predicted time to the shutdown threshold [s]
+  bool m_isPushMode;                 /// samples are pushed into m_sampleQueue instead of read from the adapter
+  BatterySampleQueue m_sampleQueue;
 
-
-  float m_battWarnThreshd;           /// Battery Voltage Warn Threshold [V]
-  float m_battStopThrshd;            /// Battery Voltage Stop Actors Threshold [V]
-  float m_battShutThrshd;            /// Battery Voltage Shutdown Threshold [V]
-  float m_battHyst;                  /// Battery Voltage Hysteresis around Threshold levels [V]
+  unsigned long m_sampleSequence;    /// number of evaluations so far
+  unsigned long m_timestampMillis;   /// BatteryAdapter::getUptimeMillis() of the latest evaluation [ms]
+  float m_rawBattSenseValue;         /// (filtered) raw ADC count of the latest evaluation
+  unsigned int m_rawBattSenseCount;  /// (filtered) raw ADC count of the latest evaluation, rounded
+  float m_rawBattSenseConvCoeff;     /// conversion coefficient of m_rawBattSenseCount, pack mode: the cell coefficient (cell sum) [V]
+  bool m_isIntegerEvaluation;        /// evaluate in the raw ADC count domain, Battery Voltage computed on demand only
+  bool m_isBatteryVoltageValid;      /// m_batteryVoltage is up to date with m_rawBattSenseCount
+  bool m_isStateOfCharge;            /// state of charge estimator enabled
+  BatteryStateOfCharge m_stateOfCharge;
+  BatteryCoulombCounter m_coulombCounter;
+  unsigned int m_numCells;           /// pack mode: number of cell channels of the latest evaluation, 0: single channel
+  unsigned int m_numCellChannels;    /// BatteryAdapter::getNumCells() as read at the last conversion coefficient update
+  float m_cellVoltageConvCoeff;      /// pack mode: combined raw count to cell voltage conversion coefficient [V]
+  float m_minCellVoltage;            /// pack mode: lowest cell voltage [V]
+  float m_maxCellVoltage;            /// pack mode: highest cell voltage [V]
+  float m_evaluationVoltage;         /// pack mode: lowest cell voltage times number of cells [V]
+  float m_cellImbalanceThreshold;    /// pack mode: cell voltage spread notification threshold [V]
+  bool m_isCellImbalance;            /// pack mode: imbalance notification fired, not yet re-armed
+  BatteryStatusSeqlock m_statusSeqlock;
+  bool m_isStatusPublished;          /// the current sample's status has been published (by a state entry)
+  BatteryTelemetryRecorder* m_telemetryRecorder;
+  unsigned long m_telemetryChannel;
+  bool m_isConversionPending;                   /// split-phase conversion started, results not evaluated yet
+  volatile unsigned long m_isConversionNotified; /// Battery::conversionComplete() called since the conversion start
+  unsigned int m_conversionNumCells;            /// cell channels of the pending conversion, 0: pack voltage channel
+  unsigned long m_conversionStartMillis;        /// BatteryAdapter::getUptimeMillis() at the conversion start [ms]
+  BatterySeqlock<BatteryThresholdConfig> m_thresholdConfig;   /// published threshold configuration
+#if BATTERY_METRICS_ENABLED
+  BatteryMetricsCollector m_metrics;
+  unsigned long m_sampleStartMicros; /// metrics: BatteryAdapter::getUptimeMicros() at the start of the current sample [us]
+#endif
 
 
   static const unsigned int s_DEFAULT_STARTUP_TIME;           /// startup timer time[ms]
   static const unsigned int s_DEFAULT_POLL_TIME;              /// status poll interval [ms]
   static const unsigned int s_DEFAULT_ASYNC_STATUS_EVAL_TIME; /// asynchronous status eval time [ms]
+  static const unsigned int s_CONVERSION_POLL_TIME;           /// split-phase conversion completion poll interval [ms]
+  static const unsigned int s_CONVERSION_TIMEOUT;             /// split-phase conversion dropped if not complete after [ms]
 
 private: // forbidden default functions
   BatteryImpl& operator = (const BatteryImpl& src); // assignment operator
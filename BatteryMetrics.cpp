@@ -0,0 +1,82 @@
+/*
+ * BatteryMetrics.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#include <string.h>
+#include "BatteryMetrics.h"
+
+const unsigned int BatteryMetrics::s_NUM_BUCKETS;
+
+BatteryMetricsCollector::BatteryMetricsCollector()
+: m_state(BattStateUnknown)
+, m_isStateEntered(false)
+, m_stateSinceMillis(0)
+, m_isPolled(false)
+, m_lastPollMicros(0)
+, m_lastPollTime(0)
+{
+  reset();
+}
+
+void BatteryMetricsCollector::reset()
+{
+  memset(&m_metrics, 0, sizeof(m_metrics));
+  m_isStateEntered = false;
+  m_isPolled = false;
+}
+
+unsigned int BatteryMetricsCollector::bucket(unsigned long micros)
+{
+  unsigned int numBits = (0 == micros) ? 0 : static_cast<unsigned int>(sizeof(unsigned long) * 8 - __builtin_clzl(micros));
+  return (numBits < BatteryMetrics::s_NUM_BUCKETS) ? numBits : (BatteryMetrics::s_NUM_BUCKETS - 1);
+}
+
+void BatteryMetricsCollector::recordAdcRead(unsigned long micros)
+{
+  m_metrics.adcReadLatency[bucket(micros)]++;
+}
+
+void BatteryMetricsCollector::recordEvaluation(unsigned long micros)
+{
+  m_metrics.evalLatency[bucket(micros)]++;
+}
+
+void BatteryMetricsCollector::recordPoll(unsigned long nowMicros, unsigned int pollTime)
+{
+  if (m_isPolled)
+  {
+    unsigned long intervalMicros = nowMicros - m_lastPollMicros;
+    unsigned long expectedMicros = m_lastPollTime * 1000ul;
+    unsigned long jitter = (intervalMicros > expectedMicros) ? (intervalMicros - expectedMicros) : (expectedMicros - intervalMicros);
+    m_metrics.pollJitter[bucket(jitter)]++;
+    m_metrics.maxPollJitter = (jitter > m_metrics.maxPollJitter) ? jitter : m_metrics.maxPollJitter;
+  }
+  m_metrics.numPolls++;
+  m_isPolled = true;
+  m_lastPollMicros = nowMicros;
+  m_lastPollTime = pollTime;
+}
+
+void BatteryMetricsCollector::recordStateEntry(BattVoltageEvalStateId state, unsigned long nowMillis)
+{
+  if (m_isStateEntered)
+  {
+    m_metrics.timeInState[m_state] += nowMillis - m_stateSinceMillis;
+  }
+  m_metrics.stateEntries[state]++;
+  m_state = static_cast<unsigned char>(state);
+  m_isStateEntered = true;
+  m_stateSinceMillis = nowMillis;
+}
+
+void BatteryMetricsCollector::read(BatteryMetrics& metrics, unsigned long nowMillis)
+{
+  memcpy(&metrics, &m_metrics, sizeof(metrics));
+  if (m_isStateEntered)
+  {
+    metrics.timeInState[m_state] += nowMillis - m_stateSinceMillis;
+  }
+}
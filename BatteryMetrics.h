@@ -0,0 +1,101 @@
+/*
+ * BatteryMetrics.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYMETRICS_H_
+#define BATTERYMETRICS_H_
+
+#include "Battery.h"
+
+/**
+ * Metrics are collected by each BatteryImpl if BATTERY_METRICS_ENABLED is non-zero.
+ * Default: disabled, the clock reads cost more than the evaluation itself; define it in the build to enable.
+ */
+#if !defined (BATTERY_METRICS_ENABLED)
+#define BATTERY_METRICS_ENABLED 0
+#endif
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Instrumentation counters of one Battery.
+ * Histograms are log2 bucketed: bucket 0 counts 0 us, bucket k counts [2^(k-1), 2^k) us,
+ * the last bucket also everything above.
+ */
+struct BatteryMetrics
+{
+  static const unsigned int s_NUM_BUCKETS = 24;         /// up to 2^23 us (8.4 s)
+
+  unsigned long adcReadLatency[s_NUM_BUCKETS];          /// BatteryAdapter raw sense value read duration histogram (split-phase: result read-out only)
+  unsigned long evalLatency[s_NUM_BUCKETS];             /// sample evaluation duration histogram (including the ADC read)
+  unsigned long pollJitter[s_NUM_BUCKETS];              /// |poll interval - configured poll time| histogram
+  unsigned long maxPollJitter;                          /// largest poll jitter seen [us]
+  unsigned long numPolls;                               /// number of poll timer evaluations
+  unsigned long stateEntries[BattStateNumStates];       /// entries per BattVoltageEvalStateId, including self re-entries
+  unsigned long timeInState[BattStateNumStates];        /// cumulative time per BattVoltageEvalStateId [ms]
+};
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Collects the BatteryMetrics of a BatteryImpl, fixed size, no allocation.
+ */
+class BatteryMetricsCollector
+{
+public:
+  BatteryMetricsCollector();
+
+  /**
+   * Clear all counters, the time in the current state restarts with the next state entry.
+   */
+  void reset();
+
+  /**
+   * Histogram bucket of a duration.
+   * @param micros Duration [us].
+   * @return Bucket index [0..BatteryMetrics::s_NUM_BUCKETS - 1].
+   */
+  static unsigned int bucket(unsigned long micros);
+
+  void recordAdcRead(unsigned long micros);
+  void recordEvaluation(unsigned long micros);
+
+  /**
+   * Record a poll timer expiry.
+   * @param nowMicros Time of the poll [us].
+   * @param pollTime Poll interval the timer has been started with [ms].
+   */
+  void recordPoll(unsigned long nowMicros, unsigned int pollTime);
+
+  /**
+   * Record a state entry.
+   * @param state State entered.
+   * @param nowMillis Time of the entry [ms].
+   */
+  void recordStateEntry(BattVoltageEvalStateId state, unsigned long nowMillis);
+
+  /**
+   * Copy the counters, the time in the current state includes the time since its entry.
+   * @param metrics Object to be filled in.
+   * @param nowMillis Current time [ms].
+   */
+  void read(BatteryMetrics& metrics, unsigned long nowMillis);
+
+private:
+  BatteryMetrics m_metrics;
+  unsigned char m_state;              /// BattVoltageEvalStateId of the current state
+  bool m_isStateEntered;              /// m_stateSinceMillis is valid
+  unsigned long m_stateSinceMillis;   /// time of the current state's entry [ms]
+  bool m_isPolled;                    /// m_lastPollMicros is valid
+  unsigned long m_lastPollMicros;     /// time of the previous poll [us]
+  unsigned int m_lastPollTime;        /// poll interval expected after the previous poll [ms]
+
+private: // forbidden default functions
+  BatteryMetricsCollector& operator = (const BatteryMetricsCollector& src); // assignment operator
+  BatteryMetricsCollector(const BatteryMetricsCollector& src);              // copy constructor
+};
+
+#endif /* BATTERYMETRICS_H_ */
@@ -0,0 +1,116 @@
+/*
+ * BatteryOcvEstimator.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#include <math.h>
+#include "BatteryOcvEstimator.h"
+
+const float BatteryOcvEstimator::s_INITIAL_RESISTANCE = 0.05;
+const float BatteryOcvEstimator::s_VOLTAGE_NOISE = 0.02;
+const float BatteryOcvEstimator::s_OCV_DRIFT = 0.002;
+const float BatteryOcvEstimator::s_RESISTANCE_DRIFT = 0.0005;
+const float BatteryOcvEstimator::s_MAX_RESISTANCE = 10.0;
+const float BatteryOcvEstimator::s_INNOVATION_GATE = 3.0;
+
+BatteryOcvEstimator::BatteryOcvEstimator(float initialResistance, float voltageNoise, float ocvDrift)
+: m_initialResistance(s_INITIAL_RESISTANCE)
+, m_measurementVariance(s_VOLTAGE_NOISE * s_VOLTAGE_NOISE)
+, m_ocvVariancePerSec(s_OCV_DRIFT * s_OCV_DRIFT)
+, m_isValid(false)
+, m_ocv(0.0)
+, m_resistance(0.0)
+, m_p00(0.0)
+, m_p01(0.0)
+, m_p11(0.0)
+, m_timestampMillis(0)
+{
+  configure(initialResistance, voltageNoise, ocvDrift);
+}
+
+void BatteryOcvEstimator::configure(float initialResistance, float voltageNoise, float ocvDrift)
+{
+  m_initialResistance = (initialResistance >= 0.0) ? initialResistance : s_INITIAL_RESISTANCE;
+  voltageNoise = (voltageNoise > 0.0) ? voltageNoise : s_VOLTAGE_NOISE;
+  ocvDrift = (ocvDrift > 0.0) ? ocvDrift : s_OCV_DRIFT;
+  m_measurementVariance = voltageNoise * voltageNoise;
+  m_ocvVariancePerSec = ocvDrift * ocvDrift;
+  reset();
+}
+
+void BatteryOcvEstimator::reset()
+{
+  m_isValid = false;
+  m_ocv = 0.0;
+  m_resistance = m_initialResistance;
+  m_p00 = 0.0;
+  m_p01 = 0.0;
+  m_p11 = 0.0;
+  m_timestampMillis = 0;
+}
+
+void BatteryOcvEstimator::update(float terminalVoltage, float current, unsigned long timestampMillis)
+{
+  if (!m_isValid)
+  {
+    // start at the measurement, R as assumed, uncertain by the voltage noise and R itself
+    m_isValid = true;
+    m_ocv = terminalVoltage + current * m_resistance;
+    m_p00 = m_measurementVariance;
+    m_p01 = 0.0;
+    m_p11 = m_resistance * m_resistance + s_RESISTANCE_DRIFT * s_RESISTANCE_DRIFT;
+    m_timestampMillis = timestampMillis;
+    return;
+  }
+
+  // predict: random walk, covariance grows with the time elapsed
+  float deltaSec = (timestampMillis - m_timestampMillis) / 1000.0;
+  m_timestampMillis = timestampMillis;
+  m_p00 += m_ocvVariancePerSec * deltaSec;
+  m_p11 += s_RESISTANCE_DRIFT * s_RESISTANCE_DRIFT * deltaSec;
+
+  // update: H = [1, -I], PH' = [p00 - I p01, p01 - I p11], S = H P H' + r
+  float ph0 = m_p00 - current * m_p01;
+  float ph1 = m_p01 - current * m_p11;
+  float s = ph0 - current * ph1 + m_measurementVariance;
+  float innovation = terminalVoltage - (m_ocv - current * m_resistance);
+  if (innovation * innovation > s_INNOVATION_GATE * s_INNOVATION_GATE * s)
+  {
+    // not explained by the model, e.g. a collapse: restart the OCV at the measurement, keep R
+    m_ocv = terminalVoltage + current * m_resistance;
+    m_p00 = m_measurementVariance;
+    m_p01 = 0.0;
+    return;
+  }
+  float k0 = ph0 / s;
+  float k1 = ph1 / s;
+  m_ocv += k0 * innovation;
+  m_resistance += k1 * innovation;
+  m_p00 -= k0 * ph0;
+  m_p01 -= k0 * ph1;
+  m_p11 -= k1 * ph1;
+
+  // keep the estimate physical and the covariance positive definite
+  m_resistance = (m_resistance < 0.0) ? 0.0 : ((m_resistance > s_MAX_RESISTANCE) ? s_MAX_RESISTANCE : m_resistance);
+  m_p00 = (m_p00 > 0.0) ? m_p00 : 0.0;
+  m_p11 = (m_p11 > 0.0) ? m_p11 : 0.0;
+  float p01Max = sqrt(m_p00 * m_p11);
+  m_p01 = (m_p01 > p01Max) ? p01Max : ((m_p01 < -p01Max) ? -p01Max : m_p01);
+}
+
+bool BatteryOcvEstimator::isValid()
+{
+  return m_isValid;
+}
+
+float BatteryOcvEstimator::ocv()
+{
+  return m_ocv;
+}
+
+float BatteryOcvEstimator::internalResistance()
+{
+  return m_resistance;
+}
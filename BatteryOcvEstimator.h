@@ -0,0 +1,90 @@
+/*
+ * BatteryOcvEstimator.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYOCVESTIMATOR_H_
+#define BATTERYOCVESTIMATOR_H_
+
+/**
+ * Open circuit voltage (OCV) and internal resistance estimator.
+ *
+ * Kalman filter over the state [OCV, R] with the terminal voltage model V = OCV - I * R, i.e. the
+ * measurement row H = [1, -I]. Both states are modelled as random walks. With a current signal the
+ * filter separates the load sag from the OCV and tracks R online; without one (I = 0) it reduces to a
+ * smoothing filter of the OCV and R is kept. A measurement further than s_INNOVATION_GATE standard deviations
+ * off the prediction is not filtered, the OCV restarts at it, so a sudden collapse shows right away instead of
+ * being averaged in at the (possibly tiny) gain of closely spaced samples. Fixed size float state (2 states,
+ * 2x2 covariance), closed form update, a constant number of operations per sample.
+ */
+class BatteryOcvEstimator
+{
+public:
+  /**
+   * Constructor.
+   * @param initialResistance Internal resistance assumed before it has been tracked [Ohm].
+   * @param voltageNoise Standard deviation of the terminal voltage measurement [V].
+   * @param ocvDrift OCV random walk [V/sqrt(s)], how fast the OCV is allowed to move.
+   */
+  BatteryOcvEstimator(float initialResistance = s_INITIAL_RESISTANCE, float voltageNoise = s_VOLTAGE_NOISE, float ocvDrift = s_OCV_DRIFT);
+
+  /**
+   * Set the filter parameters, resets the estimate.
+   */
+  void configure(float initialResistance, float voltageNoise, float ocvDrift);
+
+  /**
+   * Discard the estimate, the next update() starts over.
+   */
+  void reset();
+
+  /**
+   * Feed one sample.
+   * @param terminalVoltage Measured (loaded) voltage [V].
+   * @param current Current drawn [A], positive: discharging, 0 if not known.
+   * @param timestampMillis Time of the sample [ms].
+   */
+  void update(float terminalVoltage, float current, unsigned long timestampMillis);
+
+  /**
+   * At least one update() since the last reset().
+   */
+  bool isValid();
+
+  /**
+   * Estimated open circuit voltage [V].
+   */
+  float ocv();
+
+  /**
+   * Estimated internal resistance [Ohm].
+   */
+  float internalResistance();
+
+  static const float s_INITIAL_RESISTANCE;    /// default initial internal resistance [Ohm]
+  static const float s_VOLTAGE_NOISE;         /// default terminal voltage measurement standard deviation [V]
+  static const float s_OCV_DRIFT;             /// default OCV random walk [V/sqrt(s)]
+  static const float s_RESISTANCE_DRIFT;      /// internal resistance random walk [Ohm/sqrt(s)]
+  static const float s_MAX_RESISTANCE;        /// internal resistance estimate upper bound [Ohm]
+  static const float s_INNOVATION_GATE;       /// innovation from which on the OCV restarts at the measurement [standard deviations]
+
+private:
+  float m_initialResistance;        /// [Ohm]
+  float m_measurementVariance;      /// r [V^2]
+  float m_ocvVariancePerSec;        /// OCV process noise [V^2/s]
+  bool m_isValid;
+  float m_ocv;                      /// state: open circuit voltage [V]
+  float m_resistance;               /// state: internal resistance [Ohm]
+  float m_p00;                      /// covariance OCV, OCV [V^2]
+  float m_p01;                      /// covariance OCV, R [V Ohm]
+  float m_p11;                      /// covariance R, R [Ohm^2]
+  unsigned long m_timestampMillis;  /// time of the latest update() [ms]
+
+private: // forbidden default functions
+  BatteryOcvEstimator& operator = (const BatteryOcvEstimator& src); // assignment operator
+  BatteryOcvEstimator(const BatteryOcvEstimator& src);              // copy constructor
+};
+
+#endif /* BATTERYOCVESTIMATOR_H_ */
@@ -0,0 +1,128 @@
+/*
+ * BatterySampleFilter.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#include "BatterySampleFilter.h"
+
+const float BatterySampleFilter::s_MIN_ALPHA = 0.001;
+
+BatterySampleFilter::BatterySampleFilter()
+: m_mode(BattFilterNone)
+, m_oversampling(1)
+, m_windowSize(1)
+, m_alpha(1.0)
+, m_windowIndex(0)
+, m_windowCount(0)
+, m_windowSum(0.0)
+, m_estimate(0.0)
+{ }
+
+void BatterySampleFilter::configure(BattSampleFilterMode mode, unsigned int oversampling, unsigned int windowSize, float alpha)
+{
+  m_mode = mode;
+  m_oversampling = (oversampling < 1) ? 1 : ((oversampling > s_MAX_OVERSAMPLING) ? s_MAX_OVERSAMPLING : oversampling);
+  m_windowSize = (windowSize < 1) ? 1 : ((windowSize > s_MAX_WINDOW_SIZE) ? s_MAX_WINDOW_SIZE : windowSize);
+  m_alpha = !(alpha >= s_MIN_ALPHA) ? s_MIN_ALPHA : ((alpha > 1.0) ? 1.0 : alpha);   // NaN too
+  reset();
+}
+
+void BatterySampleFilter::reset()
+{
+  m_windowIndex = 0;
+  m_windowCount = 0;
+  m_windowSum = 0.0;
+  m_estimate = 0.0;
+}
+
+unsigned int BatterySampleFilter::oversampling()
+{
+  return m_oversampling;
+}
+
+BattSampleFilterMode BatterySampleFilter::mode()
+{
+  return m_mode;
+}
+
+float BatterySampleFilter::decimate(const unsigned int* rawSamples, unsigned int count)
+{
+  if ((0 == rawSamples) || (0 == count))
+  {
+    return 0.0;
+  }
+  unsigned long sum = 0;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    sum += rawSamples[i];
+  }
+  return static_cast<float>(sum) / count;
+}
+
+float BatterySampleFilter::filter(float sample)
+{
+  if (BattFilterExponential == m_mode)
+  {
+    // the first sample initializes the estimate
+    m_estimate = (0 == m_windowCount) ? sample : m_estimate + m_alpha * (sample - m_estimate);
+    m_windowCount = 1;
+    return m_estimate;
+  }
+
+  if (m_windowCount == m_windowSize)
+  {
+    m_windowSum -= m_window[m_windowIndex];
+  }
+  else
+  {
+    m_windowCount++;
+  }
+  m_window[m_windowIndex] = sample;
+  m_windowSum += sample;
+  m_windowIndex = (m_windowIndex + 1) % m_windowSize;
+  if (0 == m_windowIndex)
+  {
+    // once per window, re-compute the running sum to drop the rounding error accumulated by the updates
+    m_windowSum = 0.0;
+    for (unsigned int i = 0; i < m_windowCount; i++)
+    {
+      m_windowSum += m_window[i];
+    }
+  }
+
+  switch (m_mode)
+  {
+    case BattFilterMovingAverage:
+      m_estimate = m_windowSum / m_windowCount;
+      break;
+    case BattFilterMedian:
+      m_estimate = median();
+      break;
+    case BattFilterNone:
+    default:
+      m_estimate = sample;
+      break;
+  }
+  return m_estimate;
+}
+
+float BatterySampleFilter::median()
+{
+  // insertion sort of a copy, the window holds at most s_MAX_WINDOW_SIZE samples
+  float sorted[s_MAX_WINDOW_SIZE];
+  for (unsigned int i = 0; i < m_windowCount; i++)
+  {
+    float value = m_window[i];
+    unsigned int j = i;
+    while ((j > 0) && (sorted[j - 1] > value))
+    {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = value;
+  }
+  unsigned int mid = m_windowCount / 2;
+  return (0 != (m_windowCount % 2)) ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+}
@@ -0,0 +1,92 @@
+/*
+ * BatterySampleFilter.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYSAMPLEFILTER_H_
+#define BATTERYSAMPLEFILTER_H_
+
+/**
+ * Noise filter algorithms applied to the decimated raw samples.
+ */
+enum BattSampleFilterMode
+{
+  BattFilterNone = 0,       /// pass through, the latest sample is the estimate
+  BattFilterMovingAverage,  /// mean of the last windowSize samples
+  BattFilterExponential,    /// exponential smoothing, estimate += alpha * (sample - estimate)
+  BattFilterMedian          /// median of the last windowSize samples
+};
+
+/**
+ * Raw sample filter stage between the BatteryAdapter and the evaluation FSM.
+ *
+ * Each poll acquires oversampling() raw samples, decimate() averages them into one sample and filter()
+ * runs it through the configured noise filter. All history is kept in fixed size inline ring buffers.
+ */
+class BatterySampleFilter
+{
+public:
+  BatterySampleFilter();
+
+  /**
+   * Configure the filter stage, resets the filter history.
+   * @param mode Noise filter algorithm.
+   * @param oversampling Number of raw samples acquired and averaged per poll [1..s_MAX_OVERSAMPLING].
+   * @param windowSize Window of the moving average and median filters [1..s_MAX_WINDOW_SIZE].
+   * @param alpha Smoothing factor of the exponential filter [s_MIN_ALPHA..1], 1: no smoothing; 0 would freeze the estimate.
+   */
+  void configure(BattSampleFilterMode mode, unsigned int oversampling, unsigned int windowSize, float alpha);
+
+  /**
+   * Discard the filter history.
+   */
+  void reset();
+
+  /**
+   * Number of raw samples to be acquired per poll.
+   */
+  unsigned int oversampling();
+
+  BattSampleFilterMode mode();
+
+  /**
+   * Average a burst of raw samples into one sample.
+   * @param rawSamples Raw ADC counts.
+   * @param count Number of raw samples, 0 is treated as no sample (result: 0).
+   * @return Mean raw ADC count.
+   */
+  static float decimate(const unsigned int* rawSamples, unsigned int count);
+
+  /**
+   * Feed one (decimated) sample into the noise filter.
+   * @param sample Raw ADC count.
+   * @return Filtered raw ADC count estimate.
+   */
+  float filter(float sample);
+
+  static const unsigned int s_MAX_OVERSAMPLING = 16;
+  static const unsigned int s_MAX_WINDOW_SIZE = 16;
+  static const float s_MIN_ALPHA;   /// smallest smoothing factor, a time constant of about 1000 samples
+
+private:
+  float median();
+
+private:
+  BattSampleFilterMode m_mode;
+  unsigned int m_oversampling;
+  unsigned int m_windowSize;
+  float m_alpha;
+  float m_window[s_MAX_WINDOW_SIZE];  /// ring buffer of the last samples
+  unsigned int m_windowIndex;         /// ring buffer write position
+  unsigned int m_windowCount;         /// number of valid samples in the ring buffer
+  float m_windowSum;                  /// running sum of the valid samples in the ring buffer, re-computed once per window
+  float m_estimate;
+
+private: // forbidden default functions
+  BatterySampleFilter& operator = (const BatterySampleFilter& src); // assignment operator
+  BatterySampleFilter(const BatterySampleFilter& src);              // copy constructor
+};
+
+#endif /* BATTERYSAMPLEFILTER_H_ */
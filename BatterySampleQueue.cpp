@@ -0,0 +1,57 @@
+/*
+ * BatterySampleQueue.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#include "BatteryAtomic.h"
+#include "BatterySampleQueue.h"
+
+const unsigned int BatterySampleQueue::s_CAPACITY;
+const unsigned int BatterySampleQueue::s_NUM_SLOTS;
+
+BatterySampleQueue::BatterySampleQueue()
+: m_head(0)
+, m_tail(0)
+, m_numRejected(0)
+{ }
+
+bool BatterySampleQueue::push(unsigned int rawBattSenseValue, unsigned long timestampMillis)
+{
+  unsigned long head = BatteryAtomic::load(&m_head);
+  unsigned long next = (head + 1 < s_NUM_SLOTS) ? (head + 1) : 0;
+  if (next == BatteryAtomic::loadAcquire(&m_tail))
+  {
+    BatteryAtomic::store(&m_numRejected, BatteryAtomic::load(&m_numRejected) + 1);
+    return false;
+  }
+  m_samples[head].rawBattSenseValue = rawBattSenseValue;
+  m_samples[head].timestampMillis = timestampMillis;
+  BatteryAtomic::storeRelease(&m_head, next);   // the slot is written before the consumer can see it
+  return true;
+}
+
+bool BatterySampleQueue::pop(BatteryRawSample& sample)
+{
+  unsigned long tail = BatteryAtomic::load(&m_tail);
+  if (tail == BatteryAtomic::loadAcquire(&m_head))
+  {
+    return false;
+  }
+  sample = m_samples[tail];
+  BatteryAtomic::storeRelease(&m_tail, (tail + 1 < s_NUM_SLOTS) ? (tail + 1) : 0);   // the slot is read before the producer can reuse it
+  return true;
+}
+
+unsigned int BatterySampleQueue::size()
+{
+  unsigned long head = BatteryAtomic::loadAcquire(&m_head);
+  unsigned long tail = BatteryAtomic::loadAcquire(&m_tail);
+  return static_cast<unsigned int>((head >= tail) ? (head - tail) : (head + s_NUM_SLOTS - tail));
+}
+
+unsigned long BatterySampleQueue::numRejected()
+{
+  return BatteryAtomic::load(&m_numRejected);
+}
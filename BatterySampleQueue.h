@@ -0,0 +1,83 @@
+/*
+ * BatterySampleQueue.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYSAMPLEQUEUE_H_
+#define BATTERYSAMPLEQUEUE_H_
+
+/**
+ * Number of pushed samples a Battery buffers between two drains, define it in the build to override.
+ * Must not exceed 255 on 8 bit targets (the ring indices then fit into their lowest byte and cannot tear).
+ */
+#if !defined (BATTERY_SAMPLE_QUEUE_SIZE)
+#if defined (ARDUINO)
+#define BATTERY_SAMPLE_QUEUE_SIZE 8
+#else
+#define BATTERY_SAMPLE_QUEUE_SIZE 64
+#endif
+#endif
+
+/**
+ * Raw Battery Voltage sense value with its acquisition time.
+ */
+struct BatteryRawSample
+{
+  unsigned int rawBattSenseValue;   /// raw ADC count
+  unsigned long timestampMillis;    /// acquisition time, same time base as BatteryAdapter::getUptimeMillis() [ms]
+};
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Wait-free single producer / single consumer ring of raw samples, fixed capacity, no allocation.
+ * The producer (a sampler thread or an ADC interrupt) calls push() only, the consumer (the evaluating
+ * main loop or thread) calls pop() only. Neither side ever waits for the other: a full ring rejects the
+ * new sample and counts it, samples accepted by push() are all delivered by pop(), in order.
+ */
+class BatterySampleQueue
+{
+public:
+  BatterySampleQueue();
+
+  /**
+   * Producer: append a sample.
+   * @return true if queued, false if the ring is full (the sample is counted in numRejected()).
+   */
+  bool push(unsigned int rawBattSenseValue, unsigned long timestampMillis);
+
+  /**
+   * Consumer: take the oldest sample.
+   * @param sample Object to be filled in.
+   * @return true if a sample has been taken, false if the ring is empty.
+   */
+  bool pop(BatteryRawSample& sample);
+
+  /**
+   * Number of samples queued, a snapshot if called concurrently to push() or pop().
+   */
+  unsigned int size();
+
+  /**
+   * Number of samples rejected by push() because the ring was full.
+   */
+  unsigned long numRejected();
+
+  static const unsigned int s_CAPACITY = BATTERY_SAMPLE_QUEUE_SIZE;
+
+private:
+  static const unsigned int s_NUM_SLOTS = s_CAPACITY + 1;   /// one slot always stays empty, full: head + 1 == tail
+
+  BatteryRawSample m_samples[s_NUM_SLOTS];
+  volatile unsigned long m_head;          /// slot the next sample is written to, written by the producer only
+  volatile unsigned long m_tail;          /// slot the next sample is read from, written by the consumer only
+  volatile unsigned long m_numRejected;   /// written by the producer only
+
+private: // forbidden default functions
+  BatterySampleQueue& operator = (const BatterySampleQueue& src); // assignment operator
+  BatterySampleQueue(const BatterySampleQueue& src);              // copy constructor
+};
+
+#endif /* BATTERYSAMPLEQUEUE_H_ */
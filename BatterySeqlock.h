@@ -0,0 +1,96 @@
+/*
+ * BatterySeqlock.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYSEQLOCK_H_
+#define BATTERYSEQLOCK_H_
+
+#include <string.h>
+#include "BatteryAtomic.h"
+
+/**
+ * Sequence lock publishing plain data objects of type T from one writer to any number of readers.
+ * The writer never waits, readers retry while a publish is in progress and never take a lock.
+ * The sequence number doubles as generation, readers can cheaply check for a new publication.
+ */
+template <typename T>
+class BatterySeqlock
+{
+public:
+  BatterySeqlock()
+  : m_sequence(0)
+  {
+    T value;
+    memset(&value, 0, sizeof(value));
+    publish(value);
+  }
+
+  /**
+   * Publish a new value, single writer only.
+   */
+  void publish(const T& value)
+  {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    unsigned long sequence = BatteryAtomic::load(&m_sequence);
+    BatteryAtomic::store(&m_sequence, sequence + 1);   // odd: publish in progress
+    BatteryAtomic::fenceRelease();
+    for (unsigned int i = 0; i < s_NUM_WORDS - 1; i++)
+    {
+      // word by word straight from the value, no staging copy
+      unsigned long word;
+      memcpy(&word, bytes + i * sizeof(word), sizeof(word));
+      BatteryAtomic::store(&m_words[i], word);
+    }
+    unsigned long lastWord = 0;
+    memcpy(&lastWord, bytes + (s_NUM_WORDS - 1) * sizeof(lastWord), sizeof(value) - (s_NUM_WORDS - 1) * sizeof(lastWord));
+    BatteryAtomic::store(&m_words[s_NUM_WORDS - 1], lastWord);
+    BatteryAtomic::storeRelease(&m_sequence, sequence + 2);
+  }
+
+  /**
+   * Read the latest published value, lock-free, from any thread.
+   * @return Generation of the value read, see generation().
+   */
+  unsigned long read(T& value) const
+  {
+    unsigned long words[s_NUM_WORDS];
+    unsigned long sequenceBegin;
+    unsigned long sequenceEnd;
+    do
+    {
+      sequenceBegin = BatteryAtomic::loadAcquire(&m_sequence);
+      for (unsigned int i = 0; i < s_NUM_WORDS; i++)
+      {
+        words[i] = BatteryAtomic::load(&m_words[i]);
+      }
+      BatteryAtomic::fenceAcquire();
+      sequenceEnd = BatteryAtomic::load(&m_sequence);
+    } while ((0 != (sequenceBegin & 1)) || (sequenceBegin != sequenceEnd));
+    memcpy(&value, words, sizeof(value));
+    return sequenceBegin;
+  }
+
+  /**
+   * Generation of the latest publication, changes with every publish().
+   * Odd while a publish is in progress.
+   */
+  unsigned long generation() const
+  {
+    return BatteryAtomic::loadAcquire(&m_sequence);
+  }
+
+private:
+  static const unsigned int s_NUM_WORDS = (sizeof(T) + sizeof(unsigned long) - 1) / sizeof(unsigned long);
+
+  volatile unsigned long m_sequence;
+  volatile unsigned long m_words[s_NUM_WORDS];
+
+private: // forbidden default functions
+  BatterySeqlock& operator = (const BatterySeqlock& src); // assignment operator
+  BatterySeqlock(const BatterySeqlock& src);              // copy constructor
+};
+
+#endif /* BATTERYSEQLOCK_H_ */
@@ -0,0 +1,154 @@
+/*
+ * BatteryStateOfCharge.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#if defined (__AVR__)
+#include <avr/pgmspace.h>   // keep the curves out of the SRAM
+#elif !defined (PROGMEM)
+#define PROGMEM
+#endif
+#include "BatteryStateOfCharge.h"
+
+const float BatteryStateOfCharge::s_TIME_TO_EMPTY_UNKNOWN = -1.0;
+const float BatteryStateOfCharge::s_RATE_ALPHA = 0.1;
+
+const BatteryOcvPoint BatteryStateOfCharge::s_LIPO_CURVE[s_NUM_LIPO_POINTS] PROGMEM =
+{
+  { 3.27,   0.0 }, { 3.61,   5.0 }, { 3.69,  10.0 }, { 3.71,  15.0 }, { 3.73,  20.0 }, { 3.75,  25.0 }, { 3.77,  30.0 },
+  { 3.79,  35.0 }, { 3.80,  40.0 }, { 3.82,  45.0 }, { 3.84,  50.0 }, { 3.85,  55.0 }, { 3.87,  60.0 }, { 3.91,  65.0 },
+  { 3.95,  70.0 }, { 3.98,  75.0 }, { 4.02,  80.0 }, { 4.08,  85.0 }, { 4.11,  90.0 }, { 4.15,  95.0 }, { 4.20, 100.0 }
+};
+
+const BatteryOcvPoint BatteryStateOfCharge::s_LIION_CURVE[s_NUM_LIION_POINTS] PROGMEM =
+{
+  { 3.00,   0.0 }, { 3.45,  10.0 }, { 3.55,  20.0 }, { 3.62,  30.0 }, { 3.68,  40.0 }, { 3.74,  50.0 },
+  { 3.80,  60.0 }, { 3.88,  70.0 }, { 3.96,  80.0 }, { 4.06,  90.0 }, { 4.20, 100.0 }
+};
+
+const BatteryOcvPoint BatteryStateOfCharge::s_LIFEPO4_CURVE[s_NUM_LIFEPO4_POINTS] PROGMEM =
+{
+  { 2.50,   0.0 }, { 3.00,  10.0 }, { 3.20,  20.0 }, { 3.22,  30.0 }, { 3.25,  40.0 }, { 3.26,  50.0 },
+  { 3.27,  60.0 }, { 3.30,  70.0 }, { 3.32,  80.0 }, { 3.35,  90.0 }, { 3.40, 100.0 }
+};
+
+BatteryStateOfCharge::BatteryStateOfCharge(BattChemistry chemistry, unsigned int numCells)
+: m_curve(s_LIPO_CURVE)
+, m_numPoints(s_NUM_LIPO_POINTS)
+, m_invNumCells(1.0)
+, m_isValid(false)
+, m_stateOfCharge(0.0)
+, m_rate(0.0)
+, m_timestampMillis(0)
+{
+  configure(chemistry, numCells);
+}
+
+void BatteryStateOfCharge::configure(BattChemistry chemistry, unsigned int numCells)
+{
+  switch (chemistry)
+  {
+    case BattChemistryLiIon:
+      m_curve = s_LIION_CURVE;
+      m_numPoints = s_NUM_LIION_POINTS;
+      break;
+    case BattChemistryLiFePO4:
+      m_curve = s_LIFEPO4_CURVE;
+      m_numPoints = s_NUM_LIFEPO4_POINTS;
+      break;
+    case BattChemistryLiPo:
+    default:
+      m_curve = s_LIPO_CURVE;
+      m_numPoints = s_NUM_LIPO_POINTS;
+      break;
+  }
+  m_invNumCells = 1.0 / ((numCells < 1) ? 1 : numCells);
+  reset();
+}
+
+void BatteryStateOfCharge::reset()
+{
+  m_isValid = false;
+  m_stateOfCharge = 0.0;
+  m_rate = 0.0;
+  m_timestampMillis = 0;
+}
+
+void BatteryStateOfCharge::update(float batteryVoltage, unsigned long timestampMillis)
+{
+  float stateOfCharge = interpolate(m_curve, m_numPoints, batteryVoltage * m_invNumCells);
+  if (m_isValid)
+  {
+    unsigned long deltaMillis = timestampMillis - m_timestampMillis;
+    if (deltaMillis > 0)
+    {
+      float rate = (stateOfCharge - m_stateOfCharge) / deltaMillis;
+      m_rate += s_RATE_ALPHA * (rate - m_rate);
+    }
+  }
+  m_isValid = true;
+  m_stateOfCharge = stateOfCharge;
+  m_timestampMillis = timestampMillis;
+}
+
+float BatteryStateOfCharge::stateOfCharge()
+{
+  return m_stateOfCharge;
+}
+
+float BatteryStateOfCharge::timeToEmpty()
+{
+  float timeToEmpty = s_TIME_TO_EMPTY_UNKNOWN;
+  if (m_rate < 0.0)
+  {
+    timeToEmpty = m_stateOfCharge / -m_rate / 1000.0;
+  }
+  return timeToEmpty;
+}
+
+float BatteryStateOfCharge::interpolate(const BatteryOcvPoint* curve, unsigned int numPoints, float cellVoltage)
+{
+  BatteryOcvPoint first = curvePoint(curve, 0);
+  if (cellVoltage <= first.cellVoltage)
+  {
+    return first.stateOfCharge;
+  }
+  BatteryOcvPoint last = curvePoint(curve, numPoints - 1);
+  if (cellVoltage >= last.cellVoltage)
+  {
+    return last.stateOfCharge;
+  }
+
+  // find the segment [lo, lo + 1] containing cellVoltage
+  unsigned int lo = 0;
+  unsigned int hi = numPoints - 1;
+  while (hi - lo > 1)
+  {
+    unsigned int mid = (lo + hi) / 2;
+    if (curvePoint(curve, mid).cellVoltage <= cellVoltage)
+    {
+      lo = mid;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  BatteryOcvPoint p0 = curvePoint(curve, lo);
+  BatteryOcvPoint p1 = curvePoint(curve, hi);
+  return p0.stateOfCharge + (cellVoltage - p0.cellVoltage) * (p1.stateOfCharge - p0.stateOfCharge) / (p1.cellVoltage - p0.cellVoltage);
+}
+
+BatteryOcvPoint BatteryStateOfCharge::curvePoint(const BatteryOcvPoint* curve, unsigned int index)
+{
+#if defined (__AVR__)
+  BatteryOcvPoint point;
+  point.cellVoltage = pgm_read_float(&curve[index].cellVoltage);
+  point.stateOfCharge = pgm_read_float(&curve[index].stateOfCharge);
+  return point;
+#else
+  return curve[index];
+#endif
+}
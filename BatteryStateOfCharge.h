@@ -0,0 +1,114 @@
+/*
+ * BatteryStateOfCharge.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYSTATEOFCHARGE_H_
+#define BATTERYSTATEOFCHARGE_H_
+
+/**
+ * Cell chemistries with a built-in open circuit voltage (OCV) discharge curve.
+ */
+enum BattChemistry
+{
+  BattChemistryLiPo = 0,    /// Lithium Polymer, 3.27 .. 4.20 V per cell
+  BattChemistryLiIon,       /// Lithium Ion (NMC), 3.00 .. 4.20 V per cell
+  BattChemistryLiFePO4      /// Lithium Iron Phosphate, 2.50 .. 3.40 V per cell
+};
+
+/**
+ * One point of a piecewise linear OCV curve.
+ */
+struct BatteryOcvPoint
+{
+  float cellVoltage;        /// open circuit cell voltage [V], ascending within a table
+  float stateOfCharge;      /// state of charge at this voltage [%]
+};
+
+/**
+ * State of charge and time to empty estimator.
+ *
+ * The state of charge is interpolated from the chemistry's OCV curve at the pack voltage divided by the
+ * number of cells in series. The time to empty is the state of charge divided by the exponentially smoothed
+ * discharge rate, so each update() costs one binary search over the curve and a constant number of operations.
+ */
+class BatteryStateOfCharge
+{
+public:
+  /**
+   * Constructor.
+   * @param chemistry Cell chemistry, selects the OCV curve.
+   * @param numCells Number of cells in series.
+   */
+  BatteryStateOfCharge(BattChemistry chemistry = BattChemistryLiPo, unsigned int numCells = 2);
+
+  /**
+   * Select the OCV curve and the number of cells, resets the estimate.
+   */
+  void configure(BattChemistry chemistry, unsigned int numCells);
+
+  /**
+   * Discard the estimate, the next update() starts over.
+   */
+  void reset();
+
+  /**
+   * Feed one Battery Voltage sample.
+   * @param batteryVoltage Pack voltage [V].
+   * @param timestampMillis Time of the sample [ms].
+   */
+  void update(float batteryVoltage, unsigned long timestampMillis);
+
+  /**
+   * State of charge as of the latest update() [%], 0 if none yet.
+   */
+  float stateOfCharge();
+
+  /**
+   * Time to empty at the smoothed discharge rate [s], s_TIME_TO_EMPTY_UNKNOWN if not discharging or not known yet.
+   */
+  float timeToEmpty();
+
+  /**
+   * Interpolate the state of charge on a piecewise linear OCV curve, clamped to the curve's end points.
+   * @param curve OCV curve points, cellVoltage ascending; in program memory (PROGMEM) on AVR, as the built-in curves.
+   * @param numPoints Number of curve points, at least 1.
+   * @param cellVoltage Cell voltage [V].
+   * @return State of charge [%].
+   */
+  static float interpolate(const BatteryOcvPoint* curve, unsigned int numPoints, float cellVoltage);
+
+  static const float s_TIME_TO_EMPTY_UNKNOWN;   /// time to empty not available
+  static const float s_RATE_ALPHA;              /// smoothing factor of the discharge rate
+
+  static constexpr unsigned int s_NUM_LIPO_POINTS = 21;
+  static constexpr unsigned int s_NUM_LIION_POINTS = 11;
+  static constexpr unsigned int s_NUM_LIFEPO4_POINTS = 11;
+
+  static const BatteryOcvPoint s_LIPO_CURVE[s_NUM_LIPO_POINTS];         /// in program memory on AVR
+  static const BatteryOcvPoint s_LIION_CURVE[s_NUM_LIION_POINTS];       /// in program memory on AVR
+  static const BatteryOcvPoint s_LIFEPO4_CURVE[s_NUM_LIFEPO4_POINTS];   /// in program memory on AVR
+
+private:
+  /**
+   * Read a curve point, from program memory on AVR.
+   */
+  static BatteryOcvPoint curvePoint(const BatteryOcvPoint* curve, unsigned int index);
+
+private:
+  const BatteryOcvPoint* m_curve;
+  unsigned int m_numPoints;
+  float m_invNumCells;              /// 1 / number of cells in series
+  bool m_isValid;                   /// at least one update() since the last reset()
+  float m_stateOfCharge;            /// [%]
+  float m_rate;                     /// smoothed state of charge change rate [%/ms], negative: discharging
+  unsigned long m_timestampMillis;  /// time of the latest update() [ms]
+
+private: // forbidden default functions
+  BatteryStateOfCharge& operator = (const BatteryStateOfCharge& src); // assignment operator
+  BatteryStateOfCharge(const BatteryStateOfCharge& src);              // copy constructor
+};
+
+#endif /* BATTERYSTATEOFCHARGE_H_ */
@@ -0,0 +1,46 @@
+/*
+ * BatteryStatusSnapshot.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYSTATUSSNAPSHOT_H_
+#define BATTERYSTATUSSNAPSHOT_H_
+
+#include "BatterySeqlock.h"
+
+/**
+ * Consistent view of the Battery status, as of the latest evaluation.
+ */
+struct BatteryStatusSnapshot
+{
+  float batteryVoltage;           /// Battery Voltage [V]
+  unsigned char state;            /// BattVoltageEvalStateId of the current state
+  unsigned char previousState;    /// BattVoltageEvalStateId of the previous state
+  unsigned long sampleSequence;   /// number of evaluations so far, 0: none yet
+  unsigned long timestampMillis;  /// BatteryAdapter::getUptimeMillis() of the evaluation [ms]
+  unsigned int rawBattSenseValue; /// (filtered) raw ADC count, rounded, pack mode: sum of the cell counts
+  float battVoltageConvCoeff;     /// rawBattSenseValue to Battery Voltage conversion coefficient [V], pack mode: the cell coefficient
+  bool isVoltageDeferred;         /// integer evaluation: batteryVoltage not published, derived from rawBattSenseValue on read
+  float stateOfCharge;            /// state of charge [%], 0 if the estimator is disabled
+  float timeToEmpty;              /// time to empty [s], BatteryStateOfCharge::s_TIME_TO_EMPTY_UNKNOWN if not available
+  float battCurrent;              /// Battery Current [A], positive: discharging
+  float consumedCharge;           /// charge consumed since startup or reset [mAh]
+  float consumedEnergy;           /// energy consumed since startup or reset [Wh]
+  unsigned int numCells;          /// number of cell channels, 0: single pack voltage channel
+  float minCellVoltage;           /// pack mode: lowest cell voltage [V]
+  float maxCellVoltage;           /// pack mode: highest cell voltage [V]
+  float timeToWarn;               /// predicted time to the warn threshold [s], BatteryVoltageTrend::s_TIME_UNKNOWN if not available
+  float timeToStop;               /// predicted time to the stop threshold [s], BatteryVoltageTrend::s_TIME_UNKNOWN if not available
+  float timeToShutdown;           /// predicted time to the shutdown threshold [s], BatteryVoltageTrend::s_TIME_UNKNOWN if not available
+  float openCircuitVoltage;       /// estimated open circuit voltage [V], 0 if the estimator is disabled
+  float internalResistance;       /// estimated internal resistance [Ohm], 0 if the estimator is disabled
+};
+
+/**
+ * Sequence lock publishing BatteryStatusSnapshot objects from one writer to any number of readers.
+ */
+typedef BatterySeqlock<BatteryStatusSnapshot> BatteryStatusSeqlock;
+
+#endif /* BATTERYSTATUSSNAPSHOT_H_ */
@@ -0,0 +1,298 @@
+/*
+ * BatteryTelemetryLog.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#if defined (__unix__)
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <thread>
+#include "BatteryTelemetryLog.h"
+
+const char BatteryTelemetryLog::s_MAGIC[4] = { 'B', 'T', 'L', 'M' };
+const uint32_t BatteryTelemetryLog::s_VERSION = 2;
+
+BatteryTelemetryLog::BatteryTelemetryLog(const char* basePath, unsigned long recordsPerSegment, unsigned int maxSegments, unsigned int flushInterval)
+: m_basePath(new char[strlen(basePath) + 1])
+, m_recordsPerSegment((0 == recordsPerSegment) ? 1 : ((recordsPerSegment > s_MAX_RECORDS_PER_SEGMENT) ? s_MAX_RECORDS_PER_SEGMENT : recordsPerSegment))
+, m_maxSegments(maxSegments)
+, m_flushInterval((0 != flushInterval) ? flushInterval : 1)
+, m_mutex()
+, m_segment(0)
+, m_claim(m_recordsPerSegment)    // no segment: full, the writers find nothing to rotate
+, m_numWriters(0)
+, m_mappingSize(0)
+, m_segmentNumber(0)
+, m_oldestSegmentNumber(0)
+, m_numFlushed(0)
+, m_numRecordsClosed(0)
+{
+  strcpy(m_basePath, basePath);
+}
+
+BatteryTelemetryLog::~BatteryTelemetryLog()
+{
+  close();
+  delete [] m_basePath;
+  m_basePath = 0;
+}
+
+bool BatteryTelemetryLog::open()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  closeSegment();
+  // continue after the newest existing segment
+  unsigned long oldestSegmentNumber = 0;
+  unsigned long newestSegmentNumber = 0;
+  unsigned long segmentNumber = 0;
+  m_oldestSegmentNumber = 0;
+  if (scanSegments(oldestSegmentNumber, newestSegmentNumber))
+  {
+    segmentNumber = newestSegmentNumber + 1;
+    m_oldestSegmentNumber = oldestSegmentNumber;
+  }
+  m_numRecordsClosed = 0;
+  deleteSegments(segmentNumber);
+  return openSegment(segmentNumber);
+}
+
+void BatteryTelemetryLog::close()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  closeSegment();
+}
+
+void BatteryTelemetryLog::record(const BatteryTelemetryRecord& record)
+{
+  for (;;)
+  {
+    // announce before claiming, closing the segment waits for the announced writers
+    m_numWriters.fetch_add(1);
+    uint64_t claim = m_claim.fetch_add(1);
+    unsigned long slot = static_cast<unsigned long>(claim & s_SLOT_MASK);
+    if (slot < m_recordsPerSegment)
+    {
+      BatteryTelemetrySegmentHeader* segment = m_segment.load(std::memory_order_acquire);
+      reinterpret_cast<BatteryTelemetryRecord*>(segment + 1)[slot] = record;
+      m_numWriters.fetch_sub(1, std::memory_order_release);
+      if (0 == (slot + 1) % m_flushInterval)
+      {
+        flush();
+      }
+      return;
+    }
+    m_numWriters.fetch_sub(1);
+    if (!rotate(claim >> s_SLOT_BITS))
+    {
+      return;
+    }
+  }
+}
+
+bool BatteryTelemetryLog::rotate(uint64_t generation)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if ((m_claim.load() >> s_SLOT_BITS) == generation)
+  {
+    if (0 == m_segment.load())
+    {
+      return false;   // closed
+    }
+    unsigned long nextSegmentNumber = m_segmentNumber + 1;
+    closeSegment();
+    deleteSegments(nextSegmentNumber);
+    openSegment(nextSegmentNumber);
+  }
+  // else: rotated by another writer meanwhile
+  return 0 != m_segment.load();
+}
+
+void BatteryTelemetryLog::flush()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  flushSegment();
+}
+
+void BatteryTelemetryLog::flushSegment()
+{
+  BatteryTelemetrySegmentHeader* segment = m_segment.load();
+  if (0 != segment)
+  {
+    unsigned long numClaimed = static_cast<unsigned long>(m_claim.load() & s_SLOT_MASK);
+    segment->numRecords = static_cast<uint32_t>((numClaimed < m_recordsPerSegment) ? numClaimed : m_recordsPerSegment);
+    // page aligned range from the first unflushed record to the end of the last one
+    unsigned long pageSize = static_cast<unsigned long>(sysconf(_SC_PAGESIZE));
+    unsigned long begin = sizeof(BatteryTelemetrySegmentHeader) + m_numFlushed * sizeof(BatteryTelemetryRecord);
+    unsigned long end = sizeof(BatteryTelemetrySegmentHeader) + segment->numRecords * sizeof(BatteryTelemetryRecord);
+    begin -= begin % pageSize;
+    msync(segment, pageSize, MS_ASYNC);   // header page with numRecords
+    if (end > begin)
+    {
+      msync(reinterpret_cast<char*>(segment) + begin, end - begin, MS_ASYNC);
+    }
+    m_numFlushed = segment->numRecords;
+  }
+}
+
+unsigned long BatteryTelemetryLog::segmentNumber()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_segmentNumber;
+}
+
+unsigned long BatteryTelemetryLog::numRecords()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  unsigned long numClaimed = 0;
+  if (0 != m_segment.load())
+  {
+    numClaimed = static_cast<unsigned long>(m_claim.load() & s_SLOT_MASK);
+    numClaimed = (numClaimed < m_recordsPerSegment) ? numClaimed : m_recordsPerSegment;
+  }
+  return m_numRecordsClosed + numClaimed;
+}
+
+bool BatteryTelemetryLog::openSegment(unsigned long segmentNumber)
+{
+  char path[256];
+  segmentPath(segmentNumber, path, sizeof(path));
+  int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+  {
+    return false;
+  }
+  unsigned long mappingSize = sizeof(BatteryTelemetrySegmentHeader) + m_recordsPerSegment * sizeof(BatteryTelemetryRecord);
+  if (0 != ftruncate(fd, mappingSize))
+  {
+    ::close(fd);
+    return false;
+  }
+  void* mapping = mmap(0, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (MAP_FAILED == mapping)
+  {
+    return false;
+  }
+
+  BatteryTelemetrySegmentHeader* segment = static_cast<BatteryTelemetrySegmentHeader*>(mapping);
+  memcpy(segment->magic, s_MAGIC, sizeof(s_MAGIC));
+  segment->version = s_VERSION;
+  segment->recordSize = sizeof(BatteryTelemetryRecord);
+  segment->capacity = static_cast<uint32_t>(m_recordsPerSegment);
+  segment->numRecords = 0;
+  m_mappingSize = mappingSize;
+  m_segmentNumber = segmentNumber;
+  m_numFlushed = 0;
+  m_segment.store(segment, std::memory_order_release);
+  // next generation, no slot claimed: opens the segment to the writers
+  m_claim.store(((m_claim.load() >> s_SLOT_BITS) + 1) << s_SLOT_BITS);
+  return true;
+}
+
+void BatteryTelemetryLog::closeSegment()
+{
+  BatteryTelemetrySegmentHeader* segment = m_segment.load();
+  if (0 != segment)
+  {
+    // mark the segment full, then wait for the writers still storing into it
+    uint64_t claim = m_claim.exchange((m_claim.load() & ~s_SLOT_MASK) | m_recordsPerSegment);
+    unsigned long numClaimed = static_cast<unsigned long>(claim & s_SLOT_MASK);
+    while (0 != m_numWriters.load())
+    {
+      std::this_thread::yield();
+    }
+    segment->numRecords = static_cast<uint32_t>((numClaimed < m_recordsPerSegment) ? numClaimed : m_recordsPerSegment);
+    m_numRecordsClosed += segment->numRecords;
+    msync(segment, m_mappingSize, MS_ASYNC);
+    munmap(segment, m_mappingSize);
+    m_segment.store(0);
+    m_mappingSize = 0;
+  }
+}
+
+void BatteryTelemetryLog::segmentPath(unsigned long segmentNumber, char* path, unsigned int size)
+{
+  snprintf(path, size, "%s.%lu", m_basePath, segmentNumber);
+}
+
+bool BatteryTelemetryLog::scanSegments(unsigned long& oldestSegmentNumber, unsigned long& newestSegmentNumber)
+{
+  // split the base path into directory and file name prefix
+  const char* slash = strrchr(m_basePath, '/');
+  char directory[256];
+  const char* prefix = m_basePath;
+  if (0 == slash)
+  {
+    strcpy(directory, ".");
+  }
+  else
+  {
+    unsigned int length = static_cast<unsigned int>(slash - m_basePath);
+    snprintf(directory, sizeof(directory), "%.*s", (0 == length) ? 1 : length, m_basePath);
+    prefix = slash + 1;
+  }
+  DIR* dir = opendir(directory);
+  if (0 == dir)
+  {
+    return false;
+  }
+  bool isFound = false;
+  unsigned int prefixLength = static_cast<unsigned int>(strlen(prefix));
+  struct dirent* entry = 0;
+  while (0 != (entry = readdir(dir)))
+  {
+    // <prefix>.<n>, n decimal digits only
+    const char* name = entry->d_name;
+    if ((0 != strncmp(name, prefix, prefixLength)) || ('.' != name[prefixLength]))
+    {
+      continue;
+    }
+    const char* digits = name + prefixLength + 1;
+    if (('0' > digits[0]) || ('9' < digits[0]))
+    {
+      continue;
+    }
+    char* end = 0;
+    unsigned long segmentNumber = strtoul(digits, &end, 10);
+    if ('\0' != *end)
+    {
+      continue;
+    }
+    if (!isFound || (segmentNumber < oldestSegmentNumber))
+    {
+      oldestSegmentNumber = segmentNumber;
+    }
+    if (!isFound || (segmentNumber > newestSegmentNumber))
+    {
+      newestSegmentNumber = segmentNumber;
+    }
+    isFound = true;
+  }
+  closedir(dir);
+  return isFound;
+}
+
+void BatteryTelemetryLog::deleteSegments(unsigned long newestSegmentNumber)
+{
+  // keep newestSegmentNumber and the (m_maxSegments - 1) segments before it
+  if ((0 != m_maxSegments) && (newestSegmentNumber >= m_maxSegments))
+  {
+    char path[256];
+    while (m_oldestSegmentNumber <= newestSegmentNumber - m_maxSegments)
+    {
+      segmentPath(m_oldestSegmentNumber, path, sizeof(path));
+      unlink(path);
+      m_oldestSegmentNumber++;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,175 @@
+/*
+ * BatteryTelemetryLog.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYTELEMETRYLOG_H_
+#define BATTERYTELEMETRYLOG_H_
+
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Fixed width telemetry record, one per evaluated sample.
+ */
+struct BatteryTelemetryRecord
+{
+  uint64_t timestampMillis;       /// BatteryAdapter::getUptimeMillis() of the evaluation [ms], 64 bit not to wrap in long-term logs
+  uint16_t rawBattSenseValue;     /// (filtered) raw ADC count
+  uint8_t state;                  /// BattVoltageEvalStateId after the evaluation
+  uint8_t reserved;
+  float batteryVoltage;           /// Battery Voltage [V]
+  uint32_t channel;               /// channel (pack) number, as attached to the Battery
+  uint32_t padding;               /// explicit padding to the 8 byte alignment of timestampMillis
+};
+
+//-----------------------------------------------------------------------------
+
+class BatteryTelemetryRecorder
+{
+public:
+  /**
+   * Record one telemetry record, called from the evaluation of each sample.
+   */
+  virtual void record(const BatteryTelemetryRecord& record) = 0;
+
+  virtual ~BatteryTelemetryRecorder() { }
+
+protected:
+  BatteryTelemetryRecorder() { }
+
+private:  // forbidden default functions
+  BatteryTelemetryRecorder& operator = (const BatteryTelemetryRecorder& src); // assignment operator
+  BatteryTelemetryRecorder(const BatteryTelemetryRecorder& src);              // copy constructor
+};
+
+//-----------------------------------------------------------------------------
+
+#if defined (__unix__)
+
+#include <atomic>
+#include <mutex>
+
+/**
+ * Segment file layout: this header, followed by up to capacity BatteryTelemetryRecord objects.
+ */
+struct BatteryTelemetrySegmentHeader
+{
+  char magic[4];                  /// "BTLM"
+  uint32_t version;               /// BatteryTelemetryLog::s_VERSION
+  uint32_t recordSize;            /// sizeof(BatteryTelemetryRecord)
+  uint32_t capacity;              /// maximum number of records in this segment
+  uint32_t numRecords;            /// number of records in this segment, updated on flush and on rotation or close
+  uint32_t reserved[3];
+};
+
+/**
+ * Append-only binary telemetry log in memory mapped segment files <basePath>.<n>.
+ *
+ * Appending a record is a plain store into the mapped segment, the kernel is asked to write back the
+ * dirty pages asynchronously only every flushInterval records. Full segments are rotated, only the
+ * latest maxSegments segment files are kept, including the ones left over by earlier runs.
+ * Multiple writers: record() claims its slot with an atomic increment, so a log can be shared by Battery
+ * objects evaluated on different threads (e.g. stolen by BatteryEvalRuntime workers). The records of concurrent
+ * writers are in claim order, not necessarily in timestamp order. Rotation and flushing are serialized,
+ * a rotation waits for the writers still storing into the full segment.
+ */
+class BatteryTelemetryLog : public BatteryTelemetryRecorder
+{
+public:
+  /**
+   * Constructor.
+   * @param basePath Path of the segment files without the segment number suffix.
+   * @param recordsPerSegment Number of records per segment file.
+   * @param maxSegments Number of segment files kept, older ones are deleted on rotation, 0: keep all.
+   * @param flushInterval Number of records between asynchronous write backs.
+   */
+  BatteryTelemetryLog(const char* basePath, unsigned long recordsPerSegment = 65536, unsigned int maxSegments = 8, unsigned int flushInterval = 1024);
+
+  /**
+   * Destructor, flushes and closes the current segment.
+   */
+  virtual ~BatteryTelemetryLog();
+
+  /**
+   * Open a new segment, following the newest existing segment file of the same base path.
+   * Segment files beyond maxSegments left over by earlier runs are deleted.
+   * @return true on success, false otherwise.
+   */
+  bool open();
+
+  /**
+   * Flush and close the current segment.
+   */
+  void close();
+
+  /**
+   * Append a record, thread safe.
+   */
+  virtual void record(const BatteryTelemetryRecord& record);
+
+  /**
+   * Initiate the write back of all records appended so far.
+   * Records claimed but still being stored by other writers may be written back zero-filled, and complete on the next write back.
+   */
+  void flush();
+
+  /**
+   * Number of the current segment file.
+   */
+  unsigned long segmentNumber();
+
+  /**
+   * Number of records appended since open(), including the ones being stored right now.
+   */
+  unsigned long numRecords();
+
+  static const char s_MAGIC[4];
+  static const uint32_t s_VERSION;
+
+private:
+  static const unsigned int s_SLOT_BITS = 32;
+  static const uint64_t s_SLOT_MASK = 0xffffffffULL;
+  static const unsigned long s_MAX_RECORDS_PER_SEGMENT = 0x7fffffffUL;   /// leaves room for the claims of writers finding the segment full
+
+  /**
+   * Rotate to the next segment unless another writer has done so already.
+   * @param generation Generation of the full segment the caller has found.
+   * @return true if there is a segment to retry with, false otherwise.
+   */
+  bool rotate(uint64_t generation);
+
+  void flushSegment();
+  bool openSegment(unsigned long segmentNumber);
+  void closeSegment();
+  void segmentPath(unsigned long segmentNumber, char* path, unsigned int size);
+  bool scanSegments(unsigned long& oldestSegmentNumber, unsigned long& newestSegmentNumber);
+  void deleteSegments(unsigned long newestSegmentNumber);
+
+private:
+  char* m_basePath;
+  unsigned long m_recordsPerSegment;
+  unsigned int m_maxSegments;
+  unsigned int m_flushInterval;
+
+  std::mutex m_mutex;                          /// serializes rotation, flushing, open() and close()
+  std::atomic<BatteryTelemetrySegmentHeader*> m_segment;   /// mapped segment, 0 if none is open
+  std::atomic<uint64_t> m_claim;               /// segment generation (upper 32 bit) and slots claimed in it (lower 32 bit, may exceed the capacity)
+  std::atomic<unsigned long> m_numWriters;     /// writers between claiming and storing, closing a segment waits for 0
+  unsigned long m_mappingSize;
+  unsigned long m_segmentNumber;
+  unsigned long m_oldestSegmentNumber;         /// oldest segment file possibly still present
+  unsigned long m_numFlushed;                  /// records of the current segment already flushed
+  unsigned long m_numRecordsClosed;            /// records of the segments closed since open()
+
+private: // forbidden default functions
+  BatteryTelemetryLog& operator = (const BatteryTelemetryLog& src); // assignment operator
+  BatteryTelemetryLog(const BatteryTelemetryLog& src);              // copy constructor
+};
+
+#endif
+
+#endif /* BATTERYTELEMETRYLOG_H_ */
@@ -0,0 +1,239 @@
+/*
+ * BatteryTraceReplay.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#if defined (__unix__)
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "BatteryTraceReplay.h"
+
+BatteryTraceReplayAdapter::BatteryTraceReplayAdapter(BatteryTraceReplay* replay, float battVoltageSenseFactor, float vAdcFullrange, unsigned int nAdcFullrange)
+: m_replay(replay)
+, m_battVoltageSenseFactor(battVoltageSenseFactor)
+, m_vAdcFullrange(vAdcFullrange)
+, m_nAdcFullrange(nAdcFullrange)
+, m_rawValue(0)
+, m_timestampMillis(0)
+{ }
+
+unsigned int BatteryTraceReplayAdapter::readRawBattSenseValue()
+{
+  return m_rawValue;
+}
+
+float BatteryTraceReplayAdapter::readBattVoltageSenseFactor()
+{
+  return m_battVoltageSenseFactor;
+}
+
+float BatteryTraceReplayAdapter::getVAdcFullrange()
+{
+  return m_vAdcFullrange;
+}
+
+unsigned int BatteryTraceReplayAdapter::getNAdcFullrange()
+{
+  return m_nAdcFullrange;
+}
+
+unsigned long BatteryTraceReplayAdapter::getUptimeMillis()
+{
+  return static_cast<unsigned long>(m_timestampMillis);   // the Battery's clock, wraps like millis() on 32 bit targets
+}
+
+void BatteryTraceReplayAdapter::notifyBattVoltageOk()
+{
+  m_replay->notifyStateEntry(BattStateOk);
+}
+
+void BatteryTraceReplayAdapter::notifyBattVoltageBelowWarnThreshold()
+{
+  m_replay->notifyStateEntry(BattStateVoltageBelowWarn);
+}
+
+void BatteryTraceReplayAdapter::notifyBattVoltageBelowStopThreshold()
+{
+  m_replay->notifyStateEntry(BattStateVoltageBelowStop);
+}
+
+void BatteryTraceReplayAdapter::notifyBattVoltageBelowShutdownThreshold()
+{
+  m_replay->notifyStateEntry(BattStateVoltageBelowShutdown);
+}
+
+void BatteryTraceReplayAdapter::setSample(unsigned int rawValue, uint64_t timestampMillis)
+{
+  m_rawValue = rawValue;
+  m_timestampMillis = timestampMillis;
+}
+
+//-----------------------------------------------------------------------------
+
+const char BatteryTraceReplay::s_MAGIC[4] = { 'B', 'T', 'R', 'C' };
+const uint32_t BatteryTraceReplay::s_VERSION = 2;
+
+BatteryTraceReplay::BatteryTraceReplay(float battVoltageSenseFactor, float vAdcFullrange, unsigned int nAdcFullrange, BatteryThresholdConfig batteryThresholdConfig, BatteryTraceReplayListener* listener)
+: m_listener(listener)
+, m_adapter(this, battVoltageSenseFactor, vAdcFullrange, nAdcFullrange)
+, m_battery(&m_adapter, batteryThresholdConfig)
+, m_state(BattStateUnknown)
+, m_numEvents(0)
+, m_samplePeriodMillis(0)
+, m_timestampMillis(0)
+, m_sampleIndex(0)
+, m_mapping(0)
+, m_mappingSize(0)
+{
+  m_battery.battVoltageSensFactorChanged();   // take over the sense factor of the trace
+}
+
+BatteryTraceReplay::~BatteryTraceReplay()
+{
+  close();
+  m_listener = 0;
+}
+
+void BatteryTraceReplay::attachListener(BatteryTraceReplayListener* listener)
+{
+  m_listener = listener;
+}
+
+bool BatteryTraceReplay::open(const char* path)
+{
+  close();
+  int fd = ::open(path, O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+  struct stat fileStat;
+  if ((0 != fstat(fd, &fileStat)) || (static_cast<unsigned long>(fileStat.st_size) < sizeof(BatteryTraceHeader)))
+  {
+    ::close(fd);
+    return false;
+  }
+  void* mapping = mmap(0, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (MAP_FAILED == mapping)
+  {
+    return false;
+  }
+
+  const BatteryTraceHeader* header = static_cast<const BatteryTraceHeader*>(mapping);
+  if ((0 != memcmp(header->magic, s_MAGIC, sizeof(s_MAGIC))) || (s_VERSION != header->version))
+  {
+    munmap(mapping, fileStat.st_size);
+    return false;
+  }
+  madvise(mapping, fileStat.st_size, MADV_SEQUENTIAL);
+  m_mapping = mapping;
+  m_mappingSize = fileStat.st_size;
+  return true;
+}
+
+void BatteryTraceReplay::close()
+{
+  if (0 != m_mapping)
+  {
+    munmap(m_mapping, m_mappingSize);
+    m_mapping = 0;
+    m_mappingSize = 0;
+  }
+}
+
+unsigned long BatteryTraceReplay::numSamples()
+{
+  unsigned long numSamples = 0;
+  if (0 != m_mapping)
+  {
+    numSamples = (m_mappingSize - sizeof(BatteryTraceHeader)) / sizeof(uint16_t);
+  }
+  return numSamples;
+}
+
+Battery* BatteryTraceReplay::battery()
+{
+  return &m_battery;
+}
+
+unsigned long BatteryTraceReplay::replay()
+{
+  if (0 == m_mapping)
+  {
+    return 0;
+  }
+  const BatteryTraceHeader* header = static_cast<const BatteryTraceHeader*>(m_mapping);
+  startClock(header->startTimestampMillis, header->samplePeriodMillis);
+  const uint16_t* rawSamples = reinterpret_cast<const uint16_t*>(static_cast<const char*>(m_mapping) + sizeof(BatteryTraceHeader));
+  return replay(rawSamples, numSamples());
+}
+
+unsigned long BatteryTraceReplay::replay(const uint16_t* rawSamples, unsigned long count)
+{
+  m_numEvents = 0;
+  for (unsigned long i = 0; i < count; i++)
+  {
+    m_adapter.setSample(rawSamples[i], m_timestampMillis);
+    m_battery.evaluateBatteryState();
+    m_sampleIndex++;
+    m_timestampMillis += m_samplePeriodMillis;
+  }
+  return m_numEvents;
+}
+
+void BatteryTraceReplay::notifyStateEntry(BattVoltageEvalStateId stateId)
+{
+  m_numEvents++;
+  if (0 != m_listener)
+  {
+    BatteryTransitionEvent event;
+    event.previousState = m_state;
+    event.state = stateId;
+    event.batteryVoltage = m_battery.getBatteryVoltage();   // published before the entry
+    event.timestampMillis = static_cast<unsigned long>(m_timestampMillis);
+    event.sampleIndex = m_sampleIndex;
+    m_listener->notifyTransition(event);
+  }
+  m_state = stateId;
+}
+
+void BatteryTraceReplay::startClock(uint64_t startTimestampMillis, unsigned long samplePeriodMillis)
+{
+  m_samplePeriodMillis = samplePeriodMillis;
+  m_timestampMillis = startTimestampMillis;
+  m_sampleIndex = 0;
+}
+
+BattVoltageEvalStateId BatteryTraceReplay::state()
+{
+  return m_state;
+}
+
+bool BatteryTraceReplay::writeTrace(const char* path, unsigned long samplePeriodMillis, uint64_t startTimestampMillis, const uint16_t* rawSamples, unsigned long count)
+{
+  FILE* file = fopen(path, "wb");
+  if (0 == file)
+  {
+    return false;
+  }
+  BatteryTraceHeader header;
+  memcpy(header.magic, s_MAGIC, sizeof(s_MAGIC));
+  header.version = s_VERSION;
+  header.samplePeriodMillis = static_cast<uint32_t>(samplePeriodMillis);
+  header.reserved = 0;
+  header.startTimestampMillis = startTimestampMillis;
+  bool isOk = (1 == fwrite(&header, sizeof(header), 1, file));
+  isOk = isOk && (count == fwrite(rawSamples, sizeof(uint16_t), count, file));
+  isOk = (0 == fclose(file)) && isOk;
+  return isOk;
+}
+
+#endif
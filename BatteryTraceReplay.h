@@ -0,0 +1,205 @@
+/*
+ * BatteryTraceReplay.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYTRACEREPLAY_H_
+#define BATTERYTRACEREPLAY_H_
+
+#if defined (__unix__)
+
+#include <stdint.h>
+#include "Battery.h"
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Recorded trace file layout: this header, followed by numSamples raw ADC counts (uint16_t, host byte order),
+ * one every samplePeriodMillis.
+ */
+struct BatteryTraceHeader
+{
+  char magic[4];                  /// "BTRC"
+  uint32_t version;               /// s_VERSION
+  uint32_t samplePeriodMillis;    /// sample interval [ms]
+  uint32_t reserved;              /// 0, aligns the timestamp
+  uint64_t startTimestampMillis;  /// timestamp of the first sample [ms], 64 bit: traces may span more than 49.7 days
+};
+
+//-----------------------------------------------------------------------------
+
+class BatteryTraceReplayListener
+{
+public:
+  /**
+   * Notify a state entry of the replayed Battery, in trace order: one event per notification the Battery fires,
+   * i.e. also the re-entries of BattStateVoltageBelowShutdown (previousState == state) unless coalescing is
+   * configured, see Battery::configureTransitionQualification().
+   */
+  virtual void notifyTransition(const BatteryTransitionEvent& event) { }
+
+  virtual ~BatteryTraceReplayListener() { }
+
+protected:
+  BatteryTraceReplayListener() { }
+
+private:  // forbidden default functions
+  BatteryTraceReplayListener& operator = (const BatteryTraceReplayListener& src); // assignment operator
+  BatteryTraceReplayListener(const BatteryTraceReplayListener& src);              // copy constructor
+};
+
+//-----------------------------------------------------------------------------
+
+class BatteryTraceReplay;
+
+/**
+ * Adapter feeding the replayed samples to the Battery on the virtual clock of the replay,
+ * turning the Battery's notifications into BatteryTransitionEvent objects.
+ */
+class BatteryTraceReplayAdapter : public BatteryAdapter
+{
+public:
+  BatteryTraceReplayAdapter(BatteryTraceReplay* replay, float battVoltageSenseFactor, float vAdcFullrange, unsigned int nAdcFullrange);
+  virtual ~BatteryTraceReplayAdapter() { }
+
+  unsigned int readRawBattSenseValue();
+  float readBattVoltageSenseFactor();
+  float getVAdcFullrange();
+  unsigned int getNAdcFullrange();
+  unsigned long getUptimeMillis();
+
+  void notifyBattVoltageOk();
+  void notifyBattVoltageBelowWarnThreshold();
+  void notifyBattVoltageBelowStopThreshold();
+  void notifyBattVoltageBelowShutdownThreshold();
+
+  /**
+   * Set the sample for the next evaluation.
+   */
+  void setSample(unsigned int rawValue, uint64_t timestampMillis);
+
+private:
+  BatteryTraceReplay* m_replay;
+  float m_battVoltageSenseFactor;
+  float m_vAdcFullrange;
+  unsigned int m_nAdcFullrange;
+  unsigned int m_rawValue;
+  uint64_t m_timestampMillis;
+
+private: // forbidden default functions
+  BatteryTraceReplayAdapter& operator = (const BatteryTraceReplayAdapter& src); // assignment operator
+  BatteryTraceReplayAdapter(const BatteryTraceReplayAdapter& src);              // copy constructor
+};
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Replays recorded raw ADC traces through a complete Battery as fast as the CPU allows, with a virtual clock
+ * derived from the sample period: the sample filter, the transition qualification, multi-level transitions,
+ * the OCV estimate and the integer evaluation take part as configured on battery().
+ * Each sample is evaluated synchronously (Battery::evaluateBatteryState()), the Battery's own timers are not
+ * run, i.e. the confirmation bursts of the fast transitions are not replayed. The trace file is memory mapped.
+ */
+class BatteryTraceReplay
+{
+public:
+  /**
+   * Constructor.
+   * @param battVoltageSenseFactor Battery Voltage Sense Factor the trace has been recorded with.
+   * @param vAdcFullrange ADC full range voltage [V].
+   * @param nAdcFullrange ADC full range count.
+   * @param batteryThresholdConfig Threshold configuration to be checked.
+   * @param listener Pointer to a BatteryTraceReplayListener object receiving the transitions, default: 0 (none)
+   */
+  BatteryTraceReplay(float battVoltageSenseFactor, float vAdcFullrange, unsigned int nAdcFullrange, BatteryThresholdConfig batteryThresholdConfig, BatteryTraceReplayListener* listener = 0);
+
+  /**
+   * Destructor, unmaps the trace file.
+   */
+  virtual ~BatteryTraceReplay();
+
+  void attachListener(BatteryTraceReplayListener* listener);
+
+  /**
+   * The replayed Battery, configure it before replaying.
+   */
+  Battery* battery();
+
+  /**
+   * Memory map a recorded trace file.
+   * @param path Trace file path.
+   * @return true if the file has been mapped and has a valid header, false otherwise.
+   */
+  bool open(const char* path);
+
+  /**
+   * Unmap the trace file.
+   */
+  void close();
+
+  /**
+   * Number of samples of the mapped trace.
+   */
+  unsigned long numSamples();
+
+  /**
+   * Replay the whole mapped trace, with the virtual clock at the trace's start timestamp.
+   * The Battery starts in BattStateUnknown on the first replay only, use a new BatteryTraceReplay to start over.
+   * @return Number of events notified, see BatteryTraceReplayListener::notifyTransition().
+   */
+  unsigned long replay();
+
+  /**
+   * Replay samples from memory, continuing from the current state and virtual clock.
+   * @param rawSamples Raw ADC counts.
+   * @param count Number of samples.
+   * @return Number of events notified, see BatteryTraceReplayListener::notifyTransition().
+   */
+  unsigned long replay(const uint16_t* rawSamples, unsigned long count);
+
+  /**
+   * Set the virtual clock and restart the sample index, the Battery keeps its state.
+   */
+  void startClock(uint64_t startTimestampMillis, unsigned long samplePeriodMillis);
+
+  BattVoltageEvalStateId state();
+
+  /**
+   * Write a trace file.
+   * @return true on success, false otherwise.
+   */
+  static bool writeTrace(const char* path, unsigned long samplePeriodMillis, uint64_t startTimestampMillis, const uint16_t* rawSamples, unsigned long count);
+
+  static const char s_MAGIC[4];
+  static const uint32_t s_VERSION;
+
+private:
+  friend class BatteryTraceReplayAdapter;
+
+  /**
+   * Called by the adapter on each notification of the Battery.
+   */
+  void notifyStateEntry(BattVoltageEvalStateId stateId);
+
+  BatteryTraceReplayListener* m_listener;
+  BatteryTraceReplayAdapter m_adapter;
+  Battery m_battery;
+  BattVoltageEvalStateId m_state;     /// state entered by the latest notification
+  unsigned long m_numEvents;          /// notifications of the running replay
+  unsigned long m_samplePeriodMillis;
+  uint64_t m_timestampMillis;         /// virtual clock, time of the next sample [ms], does not wrap
+  unsigned long m_sampleIndex;        /// index of the next sample
+
+  void* m_mapping;
+  unsigned long m_mappingSize;
+
+private: // forbidden default functions
+  BatteryTraceReplay& operator = (const BatteryTraceReplay& src); // assignment operator
+  BatteryTraceReplay(const BatteryTraceReplay& src);              // copy constructor
+};
+
+#endif
+
+#endif /* BATTERYTRACEREPLAY_H_ */
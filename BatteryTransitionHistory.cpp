@@ -0,0 +1,59 @@
+/*
+ * BatteryTransitionHistory.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#include "BatteryTransitionHistory.h"
+
+const unsigned int BatteryTransitionHistory::s_CAPACITY;
+
+BatteryTransitionHistory::BatteryTransitionHistory()
+: m_next(0)
+, m_size(0)
+, m_numRecorded(0)
+{ }
+
+void BatteryTransitionHistory::clear()
+{
+  m_next = 0;
+  m_size = 0;
+  m_numRecorded = 0;
+}
+
+void BatteryTransitionHistory::record(BattVoltageEvalStateId previousState, BattVoltageEvalStateId state, float batteryVoltage, unsigned long timestampMillis, unsigned long sampleIndex)
+{
+  BatteryTransitionEvent& event = m_events[m_next];
+  event.previousState = static_cast<unsigned char>(previousState);
+  event.state = static_cast<unsigned char>(state);
+  event.batteryVoltage = batteryVoltage;
+  event.timestampMillis = timestampMillis;
+  event.sampleIndex = sampleIndex;
+
+  m_next = (m_next + 1 < s_CAPACITY) ? (m_next + 1) : 0;
+  m_size = (m_size < s_CAPACITY) ? (m_size + 1) : s_CAPACITY;
+  m_numRecorded++;
+}
+
+unsigned int BatteryTransitionHistory::size() const
+{
+  return m_size;
+}
+
+unsigned long BatteryTransitionHistory::numRecorded() const
+{
+  return m_numRecorded;
+}
+
+const BatteryTransitionEvent& BatteryTransitionHistory::at(unsigned int index) const
+{
+  // the oldest event is at m_next once the ring has wrapped, at 0 before
+  unsigned int slot = ((m_size < s_CAPACITY) ? 0 : m_next) + index;
+  return m_events[(slot < s_CAPACITY) ? slot : (slot - s_CAPACITY)];
+}
+
+const BatteryTransitionEvent& BatteryTransitionHistory::latest() const
+{
+  return m_events[(0 == m_next) ? (s_CAPACITY - 1) : (m_next - 1)];
+}
@@ -0,0 +1,82 @@
+/*
+ * BatteryTransitionHistory.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYTRANSITIONHISTORY_H_
+#define BATTERYTRANSITIONHISTORY_H_
+
+#include "Battery.h"
+
+/**
+ * Number of transitions kept by each Battery, define it in the build to override.
+ */
+#if !defined (BATTERY_TRANSITION_HISTORY_SIZE)
+#if defined (ARDUINO)
+#define BATTERY_TRANSITION_HISTORY_SIZE 8
+#else
+#define BATTERY_TRANSITION_HISTORY_SIZE 32
+#endif
+#endif
+
+/**
+ * Ring of the latest Battery Voltage Evaluation State transitions, fixed capacity, no allocation.
+ * Once full, each new transition overwrites the oldest one. The events are accessed in place:
+ *
+ *   for (unsigned int i = 0; i < history.size(); i++)
+ *   {
+ *     const BatteryTransitionEvent& event = history.at(i);   // 0: oldest
+ *   }
+ */
+class BatteryTransitionHistory
+{
+public:
+  BatteryTransitionHistory();
+
+  /**
+   * Discard all events.
+   */
+  void clear();
+
+  /**
+   * Append a transition, overwriting the oldest one if full.
+   */
+  void record(BattVoltageEvalStateId previousState, BattVoltageEvalStateId state, float batteryVoltage, unsigned long timestampMillis, unsigned long sampleIndex);
+
+  /**
+   * Number of events held [0..s_CAPACITY].
+   */
+  unsigned int size() const;
+
+  /**
+   * Total number of transitions recorded since the last clear(), including the overwritten ones.
+   */
+  unsigned long numRecorded() const;
+
+  /**
+   * Access an event in place.
+   * @param index Event index, 0: oldest, size() - 1: latest; must be below size().
+   */
+  const BatteryTransitionEvent& at(unsigned int index) const;
+
+  /**
+   * Latest event, size() must not be 0.
+   */
+  const BatteryTransitionEvent& latest() const;
+
+  static const unsigned int s_CAPACITY = BATTERY_TRANSITION_HISTORY_SIZE;
+
+private:
+  BatteryTransitionEvent m_events[s_CAPACITY];
+  unsigned int m_next;            /// slot the next event is written to
+  unsigned int m_size;
+  unsigned long m_numRecorded;
+
+private: // forbidden default functions
+  BatteryTransitionHistory& operator = (const BatteryTransitionHistory& src); // assignment operator
+  BatteryTransitionHistory(const BatteryTransitionHistory& src);              // copy constructor
+};
+
+#endif /* BATTERYTRANSITIONHISTORY_H_ */
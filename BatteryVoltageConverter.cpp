@@ -0,0 +1,161 @@
+/*
+ * BatteryVoltageConverter.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#include "BatteryVoltageConverter.h"
+
+#if defined (__AVX2__) || defined (__SSE2__)
+#include <immintrin.h>
+#endif
+
+void BatteryVoltageConverter::convert(const unsigned int* rawBattSenseValues, float coefficient, float* batteryVoltages, unsigned int count)
+{
+  unsigned int i = 0;
+#if defined (__AVX2__)
+  const __m256 coeff8 = _mm256_set1_ps(coefficient);
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rawBattSenseValues + i));
+    _mm256_storeu_ps(batteryVoltages + i, _mm256_mul_ps(_mm256_cvtepi32_ps(raw), coeff8));
+  }
+#endif
+#if defined (__SSE2__)
+  const __m128 coeff4 = _mm_set1_ps(coefficient);
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rawBattSenseValues + i));
+    _mm_storeu_ps(batteryVoltages + i, _mm_mul_ps(_mm_cvtepi32_ps(raw), coeff4));
+  }
+#endif
+  for (; i < count; i++)
+  {
+    batteryVoltages[i] = convert(rawBattSenseValues[i], coefficient);
+  }
+}
+
+void BatteryVoltageConverter::convert(const unsigned int* rawBattSenseValues, const float* coefficients, float* batteryVoltages, unsigned int count)
+{
+  unsigned int i = 0;
+#if defined (__AVX2__)
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rawBattSenseValues + i));
+    _mm256_storeu_ps(batteryVoltages + i, _mm256_mul_ps(_mm256_cvtepi32_ps(raw), _mm256_loadu_ps(coefficients + i)));
+  }
+#endif
+#if defined (__SSE2__)
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rawBattSenseValues + i));
+    _mm_storeu_ps(batteryVoltages + i, _mm_mul_ps(_mm_cvtepi32_ps(raw), _mm_loadu_ps(coefficients + i)));
+  }
+#endif
+  for (; i < count; i++)
+  {
+    batteryVoltages[i] = convert(rawBattSenseValues[i], coefficients[i]);
+  }
+}
+
+#if defined (__SSE2__)
+// SSE2 has no 32 bit integer min / max, select via signed compare (raw counts are below 2^31)
+static inline __m128i minEpi32(__m128i a, __m128i b)
+{
+  __m128i isGreater = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(isGreater, b), _mm_andnot_si128(isGreater, a));
+}
+
+static inline __m128i maxEpi32(__m128i a, __m128i b)
+{
+  __m128i isGreater = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(isGreater, a), _mm_andnot_si128(isGreater, b));
+}
+#endif
+
+void BatteryVoltageConverter::statistics(const unsigned int* rawSenseValues, unsigned int count, unsigned int& minRawSenseValue, unsigned int& maxRawSenseValue, unsigned int& sumRawSenseValues)
+{
+  if (0 == count)
+  {
+    minRawSenseValue = 0;
+    maxRawSenseValue = 0;
+    sumRawSenseValues = 0;
+    return;
+  }
+  unsigned int minRaw = rawSenseValues[0];
+  unsigned int maxRaw = rawSenseValues[0];
+  unsigned int sumRaw = 0;
+  unsigned int i = 0;
+#if defined (__AVX2__)
+  if (count >= 8)
+  {
+    __m256i min8 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rawSenseValues));
+    __m256i max8 = min8;
+    __m256i sum8 = _mm256_setzero_si256();
+    for (; i + 8 <= count; i += 8)
+    {
+      __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rawSenseValues + i));
+      min8 = _mm256_min_epu32(min8, raw);
+      max8 = _mm256_max_epu32(max8, raw);
+      sum8 = _mm256_add_epi32(sum8, raw);
+    }
+    unsigned int lanes[3][8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes[0]), min8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes[1]), max8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes[2]), sum8);
+    for (unsigned int k = 0; k < 8; k++)
+    {
+      minRaw = (lanes[0][k] < minRaw) ? lanes[0][k] : minRaw;
+      maxRaw = (lanes[1][k] > maxRaw) ? lanes[1][k] : maxRaw;
+      sumRaw += lanes[2][k];
+    }
+  }
+#endif
+#if defined (__SSE2__)
+  if (i + 4 <= count)
+  {
+    __m128i min4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rawSenseValues + i));
+    __m128i max4 = min4;
+    __m128i sum4 = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rawSenseValues + i));
+      min4 = minEpi32(min4, raw);
+      max4 = maxEpi32(max4, raw);
+      sum4 = _mm_add_epi32(sum4, raw);
+    }
+    unsigned int lanes[3][4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes[0]), min4);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes[1]), max4);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes[2]), sum4);
+    for (unsigned int k = 0; k < 4; k++)
+    {
+      minRaw = (lanes[0][k] < minRaw) ? lanes[0][k] : minRaw;
+      maxRaw = (lanes[1][k] > maxRaw) ? lanes[1][k] : maxRaw;
+      sumRaw += lanes[2][k];
+    }
+  }
+#endif
+  for (; i < count; i++)
+  {
+    unsigned int raw = rawSenseValues[i];
+    minRaw = (raw < minRaw) ? raw : minRaw;
+    maxRaw = (raw > maxRaw) ? raw : maxRaw;
+    sumRaw += raw;
+  }
+  minRawSenseValue = minRaw;
+  maxRawSenseValue = maxRaw;
+  sumRawSenseValues = sumRaw;
+}
+
+const char* BatteryVoltageConverter::instructionSet()
+{
+#if defined (__AVX2__)
+  return "AVX2";
+#elif defined (__SSE2__)
+  return "SSE2";
+#else
+  return "scalar";
+#endif
+}
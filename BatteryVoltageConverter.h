@@ -0,0 +1,89 @@
+/*
+ * BatteryVoltageConverter.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYVOLTAGECONVERTER_H_
+#define BATTERYVOLTAGECONVERTER_H_
+
+/**
+ * Raw ADC count to Battery Voltage conversion.
+ *
+ * The conversion voltage = raw * senseFactor * vAdcFullrange / (nAdcFullrange + 1) is folded into one
+ * combined coefficient, so each sample costs a single multiply. The bulk functions use AVX2 or SSE2 when
+ * the compiler targets them and fall back to a scalar loop otherwise. Raw counts must be below 2^31.
+ */
+class BatteryVoltageConverter
+{
+public:
+  /**
+   * Compute the combined conversion coefficient.
+   * @param battVoltageSenseFactor Battery Voltage Sense Factor (voltage divider ratio).
+   * @param vAdcFullrange ADC full range voltage [V].
+   * @param nAdcFullrange ADC full range count.
+   * @return Battery Voltage per raw ADC count [V].
+   */
+  static float conversionCoefficient(float battVoltageSenseFactor, float vAdcFullrange, unsigned int nAdcFullrange)
+  {
+    return battVoltageSenseFactor * vAdcFullrange / (nAdcFullrange + 1);
+  }
+
+  /**
+   * Convert a single raw ADC count.
+   * @param rawBattSenseValue Raw ADC count.
+   * @param coefficient Combined conversion coefficient, see conversionCoefficient().
+   * @return Battery Voltage [V].
+   */
+  static float convert(unsigned int rawBattSenseValue, float coefficient)
+  {
+    return rawBattSenseValue * coefficient;
+  }
+
+  /**
+   * Convert a single filtered (fractional) raw ADC count.
+   * @param rawBattSenseValue Raw ADC count estimate.
+   * @param coefficient Combined conversion coefficient, see conversionCoefficient().
+   * @return Battery Voltage [V].
+   */
+  static float convert(float rawBattSenseValue, float coefficient)
+  {
+    return rawBattSenseValue * coefficient;
+  }
+
+  /**
+   * Convert an array of raw ADC counts sharing the same conversion coefficient.
+   * @param rawBattSenseValues Raw ADC counts (count elements).
+   * @param coefficient Combined conversion coefficient.
+   * @param batteryVoltages Output Battery Voltages [V] (count elements).
+   * @param count Number of samples.
+   */
+  static void convert(const unsigned int* rawBattSenseValues, float coefficient, float* batteryVoltages, unsigned int count);
+
+  /**
+   * Convert an array of raw ADC counts with per-channel conversion coefficients.
+   * @param rawBattSenseValues Raw ADC counts (count elements).
+   * @param coefficients Combined conversion coefficients (count elements).
+   * @param batteryVoltages Output Battery Voltages [V] (count elements).
+   * @param count Number of samples.
+   */
+  static void convert(const unsigned int* rawBattSenseValues, const float* coefficients, float* batteryVoltages, unsigned int count);
+
+  /**
+   * Minimum, maximum and sum of an array of raw ADC counts in one pass (e.g. the cell channels of a pack).
+   * @param rawSenseValues Raw ADC counts (count elements), below 2^31 and the sum below 2^32.
+   * @param count Number of samples, 0: all results are 0.
+   * @param minRawSenseValue Output minimum raw ADC count.
+   * @param maxRawSenseValue Output maximum raw ADC count.
+   * @param sumRawSenseValues Output sum of all raw ADC counts.
+   */
+  static void statistics(const unsigned int* rawSenseValues, unsigned int count, unsigned int& minRawSenseValue, unsigned int& maxRawSenseValue, unsigned int& sumRawSenseValues);
+
+  /**
+   * Name of the instruction set the bulk functions have been compiled for ("AVX2", "SSE2" or "scalar").
+   */
+  static const char* instructionSet();
+};
+
+#endif /* BATTERYVOLTAGECONVERTER_H_ */
@@ -5,16 +5,39 @@
  *      Author: niklausd
  */
 
+#include <math.h>
 #include "BatteryImpl.h"
 #include "Battery.h"
 #include "BatteryVoltageEvalFsm.h"
+#include "BatteryVoltageConverter.h"
 
 BatteryVoltageEvalFsm::BatteryVoltageEvalFsm(BatteryImpl* battImpl)
 : m_battImpl(battImpl)
 , m_adapter(battImpl->adapter())
 , m_state(BatteryVoltageEvalFsmState_BattUnknown::Instance())
 , m_previousState(BatteryVoltageEvalFsmState_BattUnknown::Instance())
-{ }
+, m_isTableEngine(false)
+, m_tableFsm()
+, m_isMultiLevel(false)
+, m_thresholdGeneration(0)
+, m_isIntegerEvaluation(false)
+, m_isRawLevelsValid(false)
+, m_transitionHistory()
+, m_qualificationConfig()
+, m_isQualifying(false)
+, m_candidate(0)
+, m_proposalHistory(0)
+, m_proposalCount(0)
+, m_candidateSinceMillis(0)
+{
+  BatteryQualificationConfig qualificationConfig = { 1, 1, 0, false };
+  m_qualificationConfig = qualificationConfig;
+  for (unsigned int i = 0; i < BattLevelAlways; i++)
+  {
+    m_levels[i] = 0.0;
+    m_rawLevels[i] = 0;
+  }
+}
 
 BatteryVoltageEvalFsm::~BatteryVoltageEvalFsm()
 {
@@ -44,23 +67,261 @@ BatteryAdapter* BatteryVoltageEvalFsm::adapter()
 }
 
 void BatteryVoltageEvalFsm::changeState(BatteryVoltageEvalFsmState* state)
+{
+  if (state == m_state)
+  {
+    if (!m_qualificationConfig.isCoalescing)
+    {
+      // self transition, repeat the entry action; a transition pending qualification is not affected
+      enterState(state);
+    }
+    return;
+  }
+  if (!m_isQualifying || (BatteryVoltageEvalFsmState_BattUnknown::Instance() == m_state))
+  {
+    commitState(state);
+  }
+  else
+  {
+    if (isQualified(state))
+    {
+      commitState(state);
+    }
+  }
+}
+
+void BatteryVoltageEvalFsm::commitState(BatteryVoltageEvalFsmState* state)
+{
+  resetQualification();
+  enterState(state);
+}
+
+void BatteryVoltageEvalFsm::enterState(BatteryVoltageEvalFsmState* state)
 {
   m_previousState = m_state;
   m_state = state;
+  if (0 != m_battImpl)
+  {
+    if (0 != state)
+    {
+      if (m_previousState != state)
+      {
+        // self-transitions (repeated entries) would flood the history and evict the real transitions
+        m_transitionHistory.record((0 != m_previousState) ? m_previousState->id() : BattStateUnknown, state->id(),
+                                   m_battImpl->evaluationVoltage(), m_battImpl->timestampMillis(), m_battImpl->sampleSequence());
+      }
+      m_battImpl->recordStateEntry(state->id());
+    }
+    m_battImpl->publishStatus();
+  }
   if (0 != state)
   {
     state->entry(this);
   }
 }
 
+bool BatteryVoltageEvalFsm::isQualified(BatteryVoltageEvalFsmState* state)
+{
+  unsigned long nowMillis = (0 != m_battImpl) ? m_battImpl->timestampMillis() : 0;
+  if (state != m_candidate)
+  {
+    // new transition target, restart the qualification
+    resetQualification();
+    m_candidate = state;
+    m_candidateSinceMillis = nowMillis;
+  }
+  m_proposalHistory |= 1;
+  m_proposalCount++;
+  return ((m_proposalCount >= m_qualificationConfig.requiredCount) &&
+          ((nowMillis - m_candidateSinceMillis) >= m_qualificationConfig.minDwellMillis));
+}
+
+void BatteryVoltageEvalFsm::resetQualification()
+{
+  m_candidate = 0;
+  m_proposalHistory = 0;
+  m_proposalCount = 0;
+}
+
 void BatteryVoltageEvalFsm::evaluateStatus()
 {
   if ((0 != m_state) && (0 != m_adapter))
+  {
+    if ((0 != m_battImpl) && (m_battImpl->thresholdGeneration() != m_thresholdGeneration))
+    {
+      // threshold configuration replaced at runtime
+      updateThresholdLevels();
+    }
+    if (m_isQualifying && (0 != m_candidate))
+    {
+      // slide the window by one evaluation, the bit leaving the window no longer counts
+      unsigned long leavingBit = 1ul << (m_qualificationConfig.windowSize - 1);
+      if (0 != (m_proposalHistory & leavingBit))
+      {
+        m_proposalCount--;
+      }
+      m_proposalHistory = (m_proposalHistory & ~leavingBit) << 1;
+    }
+
+    BattVoltageEvalStateId stateId = m_state->id();
+    evaluateEngine();
+    if (m_isMultiLevel)
+    {
+      // keep stepping down on the same sample as long as it is below the next level too
+      while ((m_state->id() > stateId) && (m_state->id() < BattStateVoltageBelowShutdown))
+      {
+        stateId = m_state->id();
+        evaluateEngine();
+      }
+    }
+
+    if (m_isQualifying && (0 != m_candidate) && (0 == m_proposalCount))
+    {
+      // no proposal left within the window, the pending transition has been withdrawn
+      resetQualification();
+    }
+  }
+}
+
+void BatteryVoltageEvalFsm::evaluateEngine()
+{
+  if (m_isTableEngine)
+  {
+    if ((0 != m_battImpl) && m_tableFsm.evaluate(m_battImpl->evaluationVoltage()))
+    {
+      changeState(stateInstance(m_tableFsm.state()));
+      if (m_tableFsm.state() != m_state->id())
+      {
+        // transition pending or coalesced, the table engine stays in the committed state
+        m_tableFsm.setState(m_state->id());
+      }
+    }
+  }
+  else
   {
     m_state->evaluateState(this);
   }
 }
 
+void BatteryVoltageEvalFsm::setMultiLevelTransitions(bool isMultiLevel)
+{
+  m_isMultiLevel = isMultiLevel;
+}
+
+void BatteryVoltageEvalFsm::configureQualification(BatteryQualificationConfig qualificationConfig)
+{
+  unsigned int windowSize = qualificationConfig.windowSize;
+  windowSize = (windowSize < 1) ? 1 : ((windowSize > 32) ? 32 : windowSize);
+  unsigned int requiredCount = qualificationConfig.requiredCount;
+  requiredCount = (requiredCount < 1) ? 1 : ((requiredCount > windowSize) ? windowSize : requiredCount);
+  m_qualificationConfig = qualificationConfig;
+  m_qualificationConfig.windowSize = windowSize;
+  m_qualificationConfig.requiredCount = requiredCount;
+  m_isQualifying = (requiredCount > 1) || (qualificationConfig.minDwellMillis > 0);
+  resetQualification();
+}
+
+void BatteryVoltageEvalFsm::setTableEngine(bool isTableEngine)
+{
+  m_isTableEngine = isTableEngine;
+  if ((0 != m_state) && m_isTableEngine)
+  {
+    updateThresholdLevels();
+    m_tableFsm.setState(m_state->id());
+  }
+}
+
+void BatteryVoltageEvalFsm::updateThresholdLevels()
+{
+  if (0 != m_battImpl)
+  {
+    BatteryThresholdConfig batteryThresholdConfig;
+    m_thresholdGeneration = m_battImpl->getThresholdConfig(batteryThresholdConfig);
+    float hyst = batteryThresholdConfig.battHyst;
+    m_levels[BattLevelWarn] = batteryThresholdConfig.battWarnThreshd;
+    m_levels[BattLevelStop] = batteryThresholdConfig.battStopThrshd;
+    m_levels[BattLevelShut] = batteryThresholdConfig.battShutThrshd;
+    m_levels[BattLevelWarnPlusHyst] = batteryThresholdConfig.battWarnThreshd + hyst;
+    m_levels[BattLevelStopPlusHyst] = batteryThresholdConfig.battStopThrshd  + hyst;
+    m_levels[BattLevelShutPlusHyst] = batteryThresholdConfig.battShutThrshd  + hyst;
+    m_tableFsm.setThresholdConfig(batteryThresholdConfig);
+
+    // raw = V / coeff; for integer raw: L > raw * coeff <=> raw < ceil(L / coeff), L < raw * coeff <=> raw > floor(L / coeff)
+    float coeff = m_battImpl->battVoltageConvCoeff();
+    m_isRawLevelsValid = (coeff > 0.0);
+    if (m_isRawLevelsValid)
+    {
+      for (unsigned int i = BattLevelWarn; i <= BattLevelShut; i++)
+      {
+        // the quotient is rounded, step to the count where the float product compared in the voltage domain flips
+        long rawLevel = static_cast<long>(ceil(m_levels[i] / coeff));
+        rawLevel = (rawLevel < 0) ? 0 : rawLevel;
+        while (m_levels[i] > BatteryVoltageConverter::convert(static_cast<unsigned int>(rawLevel), coeff))
+        {
+          rawLevel++;
+        }
+        while ((rawLevel > 0) && !(m_levels[i] > BatteryVoltageConverter::convert(static_cast<unsigned int>(rawLevel - 1), coeff)))
+        {
+          rawLevel--;
+        }
+        m_rawLevels[i] = rawLevel;
+      }
+      for (unsigned int i = BattLevelWarnPlusHyst; i <= BattLevelShutPlusHyst; i++)
+      {
+        long rawLevel = static_cast<long>(floor(m_levels[i] / coeff));
+        rawLevel = (rawLevel < -1) ? -1 : rawLevel;
+        while ((rawLevel >= 0) && (m_levels[i] < BatteryVoltageConverter::convert(static_cast<unsigned int>(rawLevel), coeff)))
+        {
+          rawLevel--;
+        }
+        while (!(m_levels[i] < BatteryVoltageConverter::convert(static_cast<unsigned int>(rawLevel + 1), coeff)))
+        {
+          rawLevel++;
+        }
+        m_rawLevels[i] = rawLevel;
+      }
+    }
+  }
+}
+
+const BatteryTransitionHistory& BatteryVoltageEvalFsm::transitionHistory()
+{
+  return m_transitionHistory;
+}
+
+const float* BatteryVoltageEvalFsm::thresholdLevels()
+{
+  return m_levels;
+}
+
+void BatteryVoltageEvalFsm::setIntegerEvaluation(bool isIntegerEvaluation)
+{
+  m_isIntegerEvaluation = isIntegerEvaluation;
+}
+
+bool BatteryVoltageEvalFsm::isGuardBelowRawLevel(BattVoltageEvalLevelId level)
+{
+  return (static_cast<long>(m_battImpl->rawBattSenseValue()) < m_rawLevels[level]);
+}
+
+bool BatteryVoltageEvalFsm::isGuardAboveRawLevel(BattVoltageEvalLevelId level)
+{
+  return (static_cast<long>(m_battImpl->rawBattSenseValue()) > m_rawLevels[level]);
+}
+
+BatteryVoltageEvalFsmState* BatteryVoltageEvalFsm::stateInstance(BattVoltageEvalStateId stateId)
+{
+  switch (stateId)
+  {
+    case BattStateOk:                   return BatteryVoltageEvalFsmState_BattOk::Instance();
+    case BattStateVoltageBelowWarn:     return BatteryVoltageEvalFsmState_BattVoltageBelowWarn::Instance();
+    case BattStateVoltageBelowStop:     return BatteryVoltageEvalFsmState_BattVoltageBelowStop::Instance();
+    case BattStateVoltageBelowShutdown: return BatteryVoltageEvalFsmState_BattVoltageBelowShutdown::Instance();
+    case BattStateUnknown:
+    default:                            return BatteryVoltageEvalFsmState_BattUnknown::Instance();
+  }
+}
+
 bool BatteryVoltageEvalFsm::isBattVoltageOk()
 {
   return (BatteryVoltageEvalFsmState_BattOk::Instance() == m_state);
@@ -95,7 +356,14 @@ bool BatteryVoltageEvalFsm::isGuardWarn()
   bool isGuard = false;
   if (0 != m_battImpl)
   {
-    isGuard = (m_battImpl->battWarnThreshd() > m_battImpl->getBatteryVoltage());
+    if (m_isIntegerEvaluation && m_isRawLevelsValid && m_battImpl->isRawEvaluation())
+    {
+      isGuard = isGuardBelowRawLevel(BattLevelWarn);
+    }
+    else
+    {
+      isGuard = (m_levels[BattLevelWarn] > m_battImpl->evaluationVoltage());
+    }
   }
   return isGuard;
 }
@@ -105,7 +373,14 @@ bool BatteryVoltageEvalFsm::isGuardStop()
   bool isGuard = false;
   if (0 != m_battImpl)
   {
-    isGuard = (m_battImpl->battStopThrshd() > m_battImpl->getBatteryVoltage());
+    if (m_isIntegerEvaluation && m_isRawLevelsValid && m_battImpl->isRawEvaluation())
+    {
+      isGuard = isGuardBelowRawLevel(BattLevelStop);
+    }
+    else
+    {
+      isGuard = (m_levels[BattLevelStop] > m_battImpl->evaluationVoltage());
+    }
   }
   return isGuard;
 }
@@ -115,7 +390,14 @@ bool BatteryVoltageEvalFsm::isGuardShut()
   bool isGuard = false;
   if (0 != m_battImpl)
   {
-    isGuard = (m_battImpl->battShutThrshd() > m_battImpl->getBatteryVoltage());
+    if (m_isIntegerEvaluation && m_isRawLevelsValid && m_battImpl->isRawEvaluation())
+    {
+      isGuard = isGuardBelowRawLevel(BattLevelShut);
+    }
+    else
+    {
+      isGuard = (m_levels[BattLevelShut] > m_battImpl->evaluationVoltage());
+    }
   }
   return isGuard;
 }
@@ -125,7 +407,14 @@ bool BatteryVoltageEvalFsm::isGuardWarnPlusHyst()
   bool isGuard = false;
   if (0 != m_battImpl)
   {
-    isGuard = ((m_battImpl->battWarnThreshd() + m_battImpl->battHyst()) < m_battImpl->getBatteryVoltage());
+    if (m_isIntegerEvaluation && m_isRawLevelsValid && m_battImpl->isRawEvaluation())
+    {
+      isGuard = isGuardAboveRawLevel(BattLevelWarnPlusHyst);
+    }
+    else
+    {
+      isGuard = (m_levels[BattLevelWarnPlusHyst] < m_battImpl->evaluationVoltage());
+    }
   }
   return isGuard;
 }
@@ -135,7 +424,14 @@ bool BatteryVoltageEvalFsm::isGuardStopPlusHyst()
   bool isGuard = false;
   if (0 != m_battImpl)
   {
-    isGuard = ((m_battImpl->battStopThrshd() + m_battImpl->battHyst()) < m_battImpl->getBatteryVoltage());
+    if (m_isIntegerEvaluation && m_isRawLevelsValid && m_battImpl->isRawEvaluation())
+    {
+      isGuard = isGuardAboveRawLevel(BattLevelStopPlusHyst);
+    }
+    else
+    {
+      isGuard = (m_levels[BattLevelStopPlusHyst] < m_battImpl->evaluationVoltage());
+    }
   }
   return isGuard;
 }
@@ -145,22 +441,25 @@ bool BatteryVoltageEvalFsm::isGuardShutPlusHyst()
   bool isGuard = false;
   if (0 != m_battImpl)
   {
-    isGuard = ((m_battImpl->battShutThrshd() + m_battImpl->battHyst()) < m_battImpl->getBatteryVoltage());
+    if (m_isIntegerEvaluation && m_isRawLevelsValid && m_battImpl->isRawEvaluation())
+    {
+      isGuard = isGuardAboveRawLevel(BattLevelShutPlusHyst);
+    }
+    else
+    {
+      isGuard = (m_levels[BattLevelShutPlusHyst] < m_battImpl->evaluationVoltage());
+    }
   }
   return isGuard;
 }
 
 //-----------------------------------------------------------------------------
 
-BatteryVoltageEvalFsmState* BatteryVoltageEvalFsmState_BattUnknown::s_instance = 0;
+BatteryVoltageEvalFsmState_BattUnknown BatteryVoltageEvalFsmState_BattUnknown::s_instance;
 
 BatteryVoltageEvalFsmState* BatteryVoltageEvalFsmState_BattUnknown::Instance()
 {
-  if (0 == s_instance)
-  {
-    s_instance = new BatteryVoltageEvalFsmState_BattUnknown();
-  }
-  return s_instance;
+  return &s_instance;
 }
 
 const char* BatteryVoltageEvalFsmState_BattUnknown::toString()
@@ -168,6 +467,11 @@ const char* BatteryVoltageEvalFsmState_BattUnknown::toString()
   return "BattUnknown";
 }
 
+BattVoltageEvalStateId BatteryVoltageEvalFsmState_BattUnknown::id()
+{
+  return BattStateUnknown;
+}
+
 void BatteryVoltageEvalFsmState_BattUnknown::evaluateState(BatteryVoltageEvalFsm* fsm)
 {
   if (0 != fsm)
@@ -196,15 +500,11 @@ void BatteryVoltageEvalFsmState_BattUnknown::entry(BatteryVoltageEvalFsm* fsm)
 
 //-----------------------------------------------------------------------------
 
-BatteryVoltageEvalFsmState* BatteryVoltageEvalFsmState_BattOk::s_instance = 0;
+BatteryVoltageEvalFsmState_BattOk BatteryVoltageEvalFsmState_BattOk::s_instance;
 
 BatteryVoltageEvalFsmState* BatteryVoltageEvalFsmState_BattOk::Instance()
 {
-  if (0 == s_instance)
-  {
-    s_instance = new BatteryVoltageEvalFsmState_BattOk();
-  }
-  return s_instance;
+  return &s_instance;
 }
 
 const char* BatteryVoltageEvalFsmState_BattOk::toString()
@@ -212,6 +512,11 @@ const char* BatteryVoltageEvalFsmState_BattOk::toString()
   return "BattOk";
 }
 
+BattVoltageEvalStateId BatteryVoltageEvalFsmState_BattOk::id()
+{
+  return BattStateOk;
+}
+
 void BatteryVoltageEvalFsmState_BattOk::evaluateState(BatteryVoltageEvalFsm* fsm)
 {
   if (0 != fsm)
@@ -233,15 +538,11 @@ void BatteryVoltageEvalFsmState_BattOk::entry(BatteryVoltageEvalFsm* fsm)
 
 //-----------------------------------------------------------------------------
 
-BatteryVoltageEvalFsmState* BatteryVoltageEvalFsmState_BattVoltageBelowWarn::s_instance = 0;
+BatteryVoltageEvalFsmState_BattVoltageBelowWarn BatteryVoltageEvalFsmState_BattVoltageBelowWarn::s_instance;
 
 BatteryVoltageEvalFsmState* BatteryVoltageEvalFsmState_BattVoltageBelowWarn::Instance()
 {
-  if (0 == s_instance)
-  {
-    s_instance = new BatteryVoltageEvalFsmState_BattVoltageBelowWarn();
-  }
-  return s_instance;
+  return &s_instance;
 }
 
 const char* BatteryVoltageEvalFsmState_BattVoltageBelowWarn::toString()
@@ -249,6 +550,11 @@ const char* BatteryVoltageEvalFsmState_BattVoltageBelowWarn::toString()
   return "BattVoltageBelowWarn";
 }
 
+BattVoltageEvalStateId BatteryVoltageEvalFsmState_BattVoltageBelowWarn::id()
+{
+  return BattStateVoltageBelowWarn;
+}
+
 void BatteryVoltageEvalFsmState_BattVoltageBelowWarn::evaluateState(BatteryVoltageEvalFsm* fsm)
 {
   if (0 != fsm)
@@ -274,15 +580,11 @@ void BatteryVoltageEvalFsmState_BattVoltageBelowWarn::entry(BatteryVoltageEvalFs
 
 //-----------------------------------------------------------------------------
 
-BatteryVoltageEvalFsmState* BatteryVoltageEvalFsmState_BattVoltageBelowStop::s_instance = 0;
+BatteryVoltageEvalFsmState_BattVoltageBelowStop BatteryVoltageEvalFsmState_BattVoltageBelowStop::s_instance;
 
 BatteryVoltageEvalFsmState* BatteryVoltageEvalFsmState_BattVoltageBelowStop::Instance()
 {
-  if (0 == s_instance)
-  {
-    s_instance = new BatteryVoltageEvalFsmState_BattVoltageBelowStop();
-  }
-  return s_instance;
+  return &s_instance;
 }
 
 const char* BatteryVoltageEvalFsmState_BattVoltageBelowStop::toString()
@@ -290,6 +592,11 @@ const char* BatteryVoltageEvalFsmState_BattVoltageBelowStop::toString()
   return "BattVoltageBelowStop";
 }
 
+BattVoltageEvalStateId BatteryVoltageEvalFsmState_BattVoltageBelowStop::id()
+{
+  return BattStateVoltageBelowStop;
+}
+
 void BatteryVoltageEvalFsmState_BattVoltageBelowStop::evaluateState(BatteryVoltageEvalFsm* fsm)
 {
   if (0 != fsm)
@@ -315,15 +622,11 @@ void BatteryVoltageEvalFsmState_BattVoltageBelowStop::entry(BatteryVoltageEvalFs
 
 //-----------------------------------------------------------------------------
 
-BatteryVoltageEvalFsmState* BatteryVoltageEvalFsmState_BattVoltageBelowShutdown::s_instance = 0;
+BatteryVoltageEvalFsmState_BattVoltageBelowShutdown BatteryVoltageEvalFsmState_BattVoltageBelowShutdown::s_instance;
 
 BatteryVoltageEvalFsmState* BatteryVoltageEvalFsmState_BattVoltageBelowShutdown::Instance()
 {
-  if (0 == s_instance)
-  {
-    s_instance = new BatteryVoltageEvalFsmState_BattVoltageBelowShutdown();
-  }
-  return s_instance;
+  return &s_instance;
 }
 
 const char* BatteryVoltageEvalFsmState_BattVoltageBelowShutdown::toString()
@@ -331,6 +634,11 @@ const char* BatteryVoltageEvalFsmState_BattVoltageBelowShutdown::toString()
   return "BattVoltageBelowShutdown";
 }
 
+BattVoltageEvalStateId BatteryVoltageEvalFsmState_BattVoltageBelowShutdown::id()
+{
+  return BattStateVoltageBelowShutdown;
+}
+
 void BatteryVoltageEvalFsmState_BattVoltageBelowShutdown::evaluateState(BatteryVoltageEvalFsm* fsm)
 {
   if (0 != fsm)
@@ -8,6 +8,9 @@
 #ifndef BATTERYVOLTAGEEVALFSM_H_
 #define BATTERYVOLTAGEEVALFSM_H_
 
+#include "BatteryVoltageEvalTable.h"
+#include "BatteryTransitionHistory.h"
+
 class BatteryImpl;
 class BatteryAdapter;
 class BatteryVoltageEvalFsmState;
@@ -36,7 +39,8 @@ public:
   BatteryAdapter* adapter();
 
   /**
-   *
+   * Propose a transition; commits immediately unless a transition qualification is configured,
+   * see configureQualification().
    */
   void changeState(BatteryVoltageEvalFsmState* state);
 
@@ -45,6 +49,53 @@ public:
    */
   void evaluateStatus();
 
+  /**
+   * Select the evaluation engine.
+   * @param isTableEngine true: table driven BatteryVoltageEvalTableFsm, false: BatteryVoltageEvalFsmState_* classes (default)
+   */
+  void setTableEngine(bool isTableEngine);
+
+  /**
+   * Configure the transition qualification (N-of-M proposals, minimum dwell, self transition coalescing).
+   * Any pending transition is discarded.
+   */
+  void configureQualification(BatteryQualificationConfig qualificationConfig);
+
+  /**
+   * Select multi-level transitions.
+   * @param isMultiLevel true: a sample below several levels steps down through all of them within one evaluateStatus(),
+   *                     entering (and notifying) each level in order, false: one transition per evaluateStatus() (default)
+   */
+  void setMultiLevelTransitions(bool isMultiLevel);
+
+  /**
+   * Select integer domain guard evaluation.
+   * @param isIntegerEvaluation true: guards compare the raw ADC count against levels pre-converted to ADC counts, false: guards compare the Battery Voltage (default)
+   * The table engine keeps evaluating the Battery Voltage, which the BatteryImpl then computes on demand.
+   */
+  void setIntegerEvaluation(bool isIntegerEvaluation);
+
+  /**
+   * Re-compute the six guard levels, the table engine's transition levels and the raw ADC count levels
+   * from the current threshold configuration and conversion coefficient of the BatteryImpl.
+   */
+  void updateThresholdLevels();
+
+  /**
+   * Latest committed transitions, recorded by changeState().
+   */
+  const BatteryTransitionHistory& transitionHistory();
+
+  /**
+   * Guard levels in use, indexed by BattVoltageEvalLevelId (BattLevelWarn .. BattLevelShutPlusHyst) [V].
+   */
+  const float* thresholdLevels();
+
+  /**
+   * Get the state object for a state identifier.
+   */
+  static BatteryVoltageEvalFsmState* stateInstance(BattVoltageEvalStateId stateId);
+
   bool isBattVoltageOk();
   bool isBattVoltageBelowWarnThreshold();
   bool isBattVoltageBelowStopThreshold();
@@ -62,12 +113,38 @@ private:
   bool isGuardWarnPlusHyst();
   bool isGuardStopPlusHyst();
   bool isGuardShutPlusHyst();
+  /**
+   * Run the selected engine once on the current sample.
+   */
+  void evaluateEngine();
+
+  bool isQualified(BatteryVoltageEvalFsmState* state);
+  void commitState(BatteryVoltageEvalFsmState* state);
+  void enterState(BatteryVoltageEvalFsmState* state);
+  void resetQualification();
+  bool isGuardBelowRawLevel(BattVoltageEvalLevelId level);
+  bool isGuardAboveRawLevel(BattVoltageEvalLevelId level);
 
 private:
   BatteryImpl* m_battImpl;
   BatteryAdapter* m_adapter;
   BatteryVoltageEvalFsmState* m_state;
   BatteryVoltageEvalFsmState* m_previousState;
+  bool m_isTableEngine;
+  BatteryVoltageEvalTableFsm m_tableFsm;
+  bool m_isMultiLevel;                      /// step down through several levels per evaluation
+  unsigned long m_thresholdGeneration;      /// generation of the threshold configuration the levels are computed from
+  float m_levels[BattLevelAlways];          /// guard levels, indexed by BattVoltageEvalLevelId [V]
+  bool m_isIntegerEvaluation;
+  bool m_isRawLevelsValid;                  /// false if the conversion coefficient does not allow integer evaluation
+  long m_rawLevels[BattLevelAlways];        /// raw ADC count guard levels, indexed by BattVoltageEvalLevelId
+  BatteryTransitionHistory m_transitionHistory;
+  BatteryQualificationConfig m_qualificationConfig;
+  bool m_isQualifying;                      /// N-of-M or minimum dwell configured
+  BatteryVoltageEvalFsmState* m_candidate;  /// pending transition target, 0: none
+  unsigned long m_proposalHistory;          /// one bit per evaluation of the window, bit 0: latest
+  unsigned int m_proposalCount;             /// number of bits set in m_proposalHistory
+  unsigned long m_candidateSinceMillis;     /// time the pending transition has first been proposed [ms]
 
 private: // forbidden default functions
   BatteryVoltageEvalFsm& operator = (const BatteryVoltageEvalFsm& src); // assignment operator
@@ -79,7 +156,7 @@ private: // forbidden default functions
 class BatteryVoltageEvalFsmState
 {
 protected:
-  BatteryVoltageEvalFsmState() { }
+  constexpr BatteryVoltageEvalFsmState() { }
 
 public:
   virtual ~BatteryVoltageEvalFsmState() { }
@@ -92,6 +169,8 @@ public:
 
   virtual const char* toString() = 0;
 
+  virtual BattVoltageEvalStateId id() = 0;
+
 private: // forbidden default functions
   BatteryVoltageEvalFsmState& operator = (const BatteryVoltageEvalFsmState& src); // assignment operator
   BatteryVoltageEvalFsmState(const BatteryVoltageEvalFsmState& src);              // copy constructor
@@ -102,7 +181,7 @@ private: // forbidden default functions
 class BatteryVoltageEvalFsmState_BattUnknown : public BatteryVoltageEvalFsmState
 {
 private:
-  BatteryVoltageEvalFsmState_BattUnknown() { }
+  constexpr BatteryVoltageEvalFsmState_BattUnknown() { }
 
 public:
   static BatteryVoltageEvalFsmState* Instance();
@@ -115,8 +194,10 @@ public:
 
   virtual const char* toString();
 
+  virtual BattVoltageEvalStateId id();
+
 private:
-  static BatteryVoltageEvalFsmState* s_instance;
+  static BatteryVoltageEvalFsmState_BattUnknown s_instance;   /// constant initialized, no lazy construction
 
 private: // forbidden default functions
   BatteryVoltageEvalFsmState_BattUnknown& operator = (const BatteryVoltageEvalFsmState_BattUnknown& src); // assignment operator
@@ -128,7 +209,7 @@ private: // forbidden default functions
 class BatteryVoltageEvalFsmState_BattOk : public BatteryVoltageEvalFsmState
 {
 private:
-  BatteryVoltageEvalFsmState_BattOk() { }
+  constexpr BatteryVoltageEvalFsmState_BattOk() { }
 
 public:
   static BatteryVoltageEvalFsmState* Instance();
@@ -141,8 +222,10 @@ public:
 
   virtual const char* toString();
 
+  virtual BattVoltageEvalStateId id();
+
 private:
-  static BatteryVoltageEvalFsmState* s_instance;
+  static BatteryVoltageEvalFsmState_BattOk s_instance;   /// constant initialized, no lazy construction
 
 private: // forbidden default functions
   BatteryVoltageEvalFsmState_BattOk& operator = (const BatteryVoltageEvalFsmState_BattOk& src); // assignment operator
@@ -154,7 +237,7 @@ private: // forbidden default functions
 class BatteryVoltageEvalFsmState_BattVoltageBelowWarn : BatteryVoltageEvalFsmState
 {
 private:
-  BatteryVoltageEvalFsmState_BattVoltageBelowWarn() { }
+  constexpr BatteryVoltageEvalFsmState_BattVoltageBelowWarn() { }
 
 public:
   static BatteryVoltageEvalFsmState* Instance();
@@ -167,8 +250,10 @@ public:
 
   virtual const char* toString();
 
+  virtual BattVoltageEvalStateId id();
+
 private:
-  static BatteryVoltageEvalFsmState* s_instance;
+  static BatteryVoltageEvalFsmState_BattVoltageBelowWarn s_instance;   /// constant initialized, no lazy construction
 
 private: // forbidden default functions
   BatteryVoltageEvalFsmState_BattVoltageBelowWarn& operator = (const BatteryVoltageEvalFsmState_BattVoltageBelowWarn& src); // assignment operator
@@ -180,7 +265,7 @@ private: // forbidden default functions
 class BatteryVoltageEvalFsmState_BattVoltageBelowStop : BatteryVoltageEvalFsmState
 {
 private:
-  BatteryVoltageEvalFsmState_BattVoltageBelowStop() { }
+  constexpr BatteryVoltageEvalFsmState_BattVoltageBelowStop() { }
 
 public:
   static BatteryVoltageEvalFsmState* Instance();
@@ -193,8 +278,10 @@ public:
 
   virtual const char* toString();
 
+  virtual BattVoltageEvalStateId id();
+
 private:
-  static BatteryVoltageEvalFsmState* s_instance;
+  static BatteryVoltageEvalFsmState_BattVoltageBelowStop s_instance;   /// constant initialized, no lazy construction
 
 private: // forbidden default functions
   BatteryVoltageEvalFsmState_BattVoltageBelowStop& operator = (const BatteryVoltageEvalFsmState_BattVoltageBelowStop& src); // assignment operator
@@ -206,7 +293,7 @@ private: // forbidden default functions
 class BatteryVoltageEvalFsmState_BattVoltageBelowShutdown : BatteryVoltageEvalFsmState
 {
 private:
-  BatteryVoltageEvalFsmState_BattVoltageBelowShutdown() { }
+  constexpr BatteryVoltageEvalFsmState_BattVoltageBelowShutdown() { }
 
 public:
   static BatteryVoltageEvalFsmState* Instance();
@@ -219,8 +306,10 @@ public:
 
   virtual const char* toString();
 
+  virtual BattVoltageEvalStateId id();
+
 private:
-  static BatteryVoltageEvalFsmState* s_instance;
+  static BatteryVoltageEvalFsmState_BattVoltageBelowShutdown s_instance;   /// constant initialized, no lazy construction
 
 private: // forbidden default functions
   BatteryVoltageEvalFsmState_BattVoltageBelowShutdown& operator = (const BatteryVoltageEvalFsmState_BattVoltageBelowShutdown& src); // assignment operator
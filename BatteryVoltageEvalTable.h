@@ -0,0 +1,185 @@
+/*
+ * BatteryVoltageEvalTable.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYVOLTAGEEVALTABLE_H_
+#define BATTERYVOLTAGEEVALTABLE_H_
+
+#include <float.h>
+#include "Battery.h"
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Guard levels the transition rules refer to.
+ */
+enum BattVoltageEvalLevelId
+{
+  BattLevelWarn = 0,
+  BattLevelStop,
+  BattLevelShut,
+  BattLevelWarnPlusHyst,
+  BattLevelStopPlusHyst,
+  BattLevelShutPlusHyst,
+  BattLevelAlways,        /// sentinel, "below" this level is true for any sample
+  BattLevelNever,         /// sentinel, "below" this level is false for any sample
+  BattLevelNumLevels
+};
+
+/**
+ * One transition rule: fires when the voltage is below (or above) the guard level.
+ */
+struct BatteryVoltageEvalTableRule
+{
+  unsigned char level;    /// BattVoltageEvalLevelId
+  bool isAbove;           /// true: fires if voltage > level, false: fires if voltage < level
+  unsigned char target;   /// BattVoltageEvalStateId to change to
+};
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Table driven Battery Voltage Evaluation FSM.
+ *
+ * Each state has two prioritized transition rules (see rule()), the same the BatteryVoltageEvalFsmState_*
+ * classes implement. setThresholdConfig() compiles them into signed enter/exit voltages per state, so
+ * evaluate() finds the next state with two compares and selects, without virtual calls.
+ * The threshold configuration is expected to be monotonic (warn > stop > shutdown).
+ * Header-only, so that StaticBattery does not depend on any library translation unit.
+ */
+class BatteryVoltageEvalTableFsm
+{
+public:
+  BatteryVoltageEvalTableFsm()
+  : m_state(BattStateUnknown)
+  , m_previousState(BattStateUnknown)
+  { }
+
+  /**
+   * Compile the transition rules for a threshold configuration.
+   */
+  void setThresholdConfig(const BatteryThresholdConfig& batteryThresholdConfig)
+  {
+    float levels[BattLevelNumLevels];
+    levels[BattLevelWarn]         = batteryThresholdConfig.battWarnThreshd;
+    levels[BattLevelStop]         = batteryThresholdConfig.battStopThrshd;
+    levels[BattLevelShut]         = batteryThresholdConfig.battShutThrshd;
+    levels[BattLevelWarnPlusHyst] = batteryThresholdConfig.battWarnThreshd + batteryThresholdConfig.battHyst;
+    levels[BattLevelStopPlusHyst] = batteryThresholdConfig.battStopThrshd  + batteryThresholdConfig.battHyst;
+    levels[BattLevelShutPlusHyst] = batteryThresholdConfig.battShutThrshd  + batteryThresholdConfig.battHyst;
+    levels[BattLevelAlways]       = FLT_MAX;
+    levels[BattLevelNever]        = -FLT_MAX;
+
+    for (unsigned int state = 0; state < BattStateNumStates; state++)
+    {
+      for (unsigned int i = 0; i < 2; i++)
+      {
+        const BatteryVoltageEvalTableRule& rule = BatteryVoltageEvalTableFsm::rule(static_cast<BattVoltageEvalStateId>(state), i);
+        float sign = rule.isAbove ? 1.0 : -1.0;
+        m_rules[state][i].sign = sign;
+        m_rules[state][i].signedLevel = sign * levels[rule.level];
+        m_rules[state][i].target = rule.target;
+      }
+    }
+  }
+
+  /**
+   * Evaluate one Battery Voltage sample.
+   * @param batteryVoltage Battery Voltage [V].
+   * @return true if a transition fired (shutdown state re-entries included), false otherwise.
+   */
+  bool evaluate(float batteryVoltage)
+  {
+    const CompiledRule* rules = m_rules[m_state];
+    bool isFirst  = (rules[0].sign * batteryVoltage) > rules[0].signedLevel;
+    bool isSecond = (rules[1].sign * batteryVoltage) > rules[1].signedLevel;
+    unsigned char nextState = isFirst ? rules[0].target : (isSecond ? rules[1].target : m_state);
+    bool isTransition = isFirst | isSecond;
+    m_previousState = isTransition ? m_state : m_previousState;
+    m_state = nextState;
+    return isTransition;
+  }
+
+  BattVoltageEvalStateId state() const
+  {
+    return static_cast<BattVoltageEvalStateId>(m_state);
+  }
+
+  BattVoltageEvalStateId previousState() const
+  {
+    return static_cast<BattVoltageEvalStateId>(m_previousState);
+  }
+
+  /**
+   * Force the current state, e.g. to keep in sync with another FSM engine.
+   */
+  void setState(BattVoltageEvalStateId state)
+  {
+    m_state = static_cast<unsigned char>(state);
+  }
+
+  /**
+   * Restart in the given state, forgetting the previous state.
+   */
+  void reset(BattVoltageEvalStateId state)
+  {
+    m_state = static_cast<unsigned char>(state);
+    m_previousState = m_state;
+  }
+
+  /**
+   * Get a transition rule.
+   * @param state State the rule belongs to.
+   * @param priority 0: first rule, 1: second rule (applies if the first one does not fire).
+   * @return Transition rule.
+   */
+  static const BatteryVoltageEvalTableRule& rule(BattVoltageEvalStateId state, unsigned int priority)
+  {
+    // function local, so that no out-of-class definition (i.e. no translation unit) is needed
+    static constexpr BatteryVoltageEvalTableRule s_rules[BattStateNumStates][2] =
+    {
+      /* BattStateUnknown */              { { BattLevelWarnPlusHyst, true,  BattStateOk },                   { BattLevelWarn,   false, BattStateVoltageBelowWarn } },
+      /* BattStateOk */                   { { BattLevelWarn,         false, BattStateVoltageBelowWarn },     { BattLevelNever,  false, BattStateOk } },
+      /* BattStateVoltageBelowWarn */     { { BattLevelStop,         false, BattStateVoltageBelowStop },     { BattLevelWarnPlusHyst, true, BattStateOk } },
+      /* BattStateVoltageBelowStop */     { { BattLevelShut,         false, BattStateVoltageBelowShutdown }, { BattLevelStopPlusHyst, true, BattStateVoltageBelowWarn } },
+      /* BattStateVoltageBelowShutdown */ { { BattLevelShutPlusHyst, true,  BattStateVoltageBelowWarn },     { BattLevelAlways, false, BattStateVoltageBelowShutdown } }
+    };
+    return s_rules[state][priority];
+  }
+
+  /**
+   * Get the name of a Battery Voltage Evaluation State, see Battery::stateName().
+   */
+  static const char* stateName(BattVoltageEvalStateId stateId)
+  {
+    switch (stateId)
+    {
+      case BattStateOk:                   return "BattOk";
+      case BattStateVoltageBelowWarn:     return "BattVoltageBelowWarn";
+      case BattStateVoltageBelowStop:     return "BattVoltageBelowStop";
+      case BattStateVoltageBelowShutdown: return "BattVoltageBelowShutdown";
+      case BattStateUnknown:
+      default:                            return "BattUnknown";
+    }
+  }
+
+private:
+  /**
+   * A rule fires when (sign * voltage) > signedLevel, i.e. "below" rules are stored negated.
+   */
+  struct CompiledRule
+  {
+    float sign;
+    float signedLevel;
+    unsigned char target;
+  };
+
+  CompiledRule m_rules[BattStateNumStates][2];
+  unsigned char m_state;
+  unsigned char m_previousState;
+};
+
+#endif /* BATTERYVOLTAGEEVALTABLE_H_ */
@@ -0,0 +1,154 @@
+/*
+ * BatteryVoltageTrend.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#include "BatteryVoltageTrend.h"
+
+const float BatteryVoltageTrend::s_TIME_UNKNOWN = -1.0;
+const unsigned int BatteryVoltageTrend::s_MAX_WINDOW_SIZE;
+const unsigned int BatteryVoltageTrend::s_DEFAULT_WINDOW_SIZE;
+
+BatteryVoltageTrend::BatteryVoltageTrend(unsigned int windowSize)
+: m_windowSize(s_DEFAULT_WINDOW_SIZE)
+, m_next(0)
+, m_size(0)
+, m_numUpdates(0)
+, m_originMillis(0)
+, m_sumT(0.0)
+, m_sumV(0.0)
+, m_sumTT(0.0)
+, m_sumTV(0.0)
+, m_isValid(false)
+, m_slope(0.0)
+, m_fitVoltage(0.0)
+{
+  configure(windowSize);
+}
+
+void BatteryVoltageTrend::configure(unsigned int windowSize)
+{
+  m_windowSize = (windowSize < 2) ? 2 : ((windowSize > s_MAX_WINDOW_SIZE) ? s_MAX_WINDOW_SIZE : windowSize);
+  reset();
+}
+
+void BatteryVoltageTrend::reset()
+{
+  m_next = 0;
+  m_size = 0;
+  m_numUpdates = 0;
+  m_originMillis = 0;
+  m_sumT = 0.0;
+  m_sumV = 0.0;
+  m_sumTT = 0.0;
+  m_sumTV = 0.0;
+  m_isValid = false;
+  m_slope = 0.0;
+  m_fitVoltage = 0.0;
+}
+
+void BatteryVoltageTrend::update(float voltage, unsigned long timestampMillis)
+{
+  if (0 == m_size)
+  {
+    m_originMillis = timestampMillis;
+  }
+  if (m_size == m_windowSize)
+  {
+    // the slot to be overwritten holds the oldest sample
+    float t = (m_timestamps[m_next] - m_originMillis) / 1000.0;
+    float v = m_voltages[m_next];
+    m_sumT -= t;
+    m_sumV -= v;
+    m_sumTT -= t * t;
+    m_sumTV -= t * v;
+    m_size--;
+  }
+  m_voltages[m_next] = voltage;
+  m_timestamps[m_next] = timestampMillis;
+  m_next = (m_next + 1 < m_windowSize) ? (m_next + 1) : 0;
+  m_size++;
+
+  m_numUpdates++;
+  if (m_numUpdates >= m_windowSize)
+  {
+    recompute();
+  }
+  else
+  {
+    float t = (timestampMillis - m_originMillis) / 1000.0;
+    m_sumT += t;
+    m_sumV += voltage;
+    m_sumTT += t * t;
+    m_sumTV += t * voltage;
+  }
+  fit();
+}
+
+void BatteryVoltageTrend::recompute()
+{
+  unsigned int oldest = (m_size < m_windowSize) ? 0 : m_next;
+  m_originMillis = m_timestamps[oldest];
+  m_sumT = 0.0;
+  m_sumV = 0.0;
+  m_sumTT = 0.0;
+  m_sumTV = 0.0;
+  for (unsigned int i = 0; i < m_size; i++)
+  {
+    unsigned int slot = (oldest + i < m_windowSize) ? (oldest + i) : (oldest + i - m_windowSize);
+    float t = (m_timestamps[slot] - m_originMillis) / 1000.0;
+    float v = m_voltages[slot];
+    m_sumT += t;
+    m_sumV += v;
+    m_sumTT += t * t;
+    m_sumTV += t * v;
+  }
+  m_numUpdates = 0;
+}
+
+void BatteryVoltageTrend::fit()
+{
+  float n = m_size;
+  float denominator = n * m_sumTT - m_sumT * m_sumT;
+  m_isValid = (m_size >= 2) && (denominator > 1e-6);
+  if (m_isValid)
+  {
+    unsigned int latest = (0 == m_next) ? (m_windowSize - 1) : (m_next - 1);
+    float tLatest = (m_timestamps[latest] - m_originMillis) / 1000.0;
+    m_slope = (n * m_sumTV - m_sumT * m_sumV) / denominator;
+    m_fitVoltage = (m_sumV + m_slope * (n * tLatest - m_sumT)) / n;
+  }
+  else
+  {
+    m_slope = 0.0;
+  }
+}
+
+bool BatteryVoltageTrend::isValid()
+{
+  return m_isValid;
+}
+
+float BatteryVoltageTrend::slope()
+{
+  return m_slope;
+}
+
+float BatteryVoltageTrend::timeToLevel(float level)
+{
+  float timeToLevel = s_TIME_UNKNOWN;
+  if (m_isValid)
+  {
+    if (m_fitVoltage <= level)
+    {
+      timeToLevel = 0.0;
+    }
+    else if (m_slope < 0.0)
+    {
+      timeToLevel = (level - m_fitVoltage) / m_slope;
+    }
+  }
+  return timeToLevel;
+}
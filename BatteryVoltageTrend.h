@@ -0,0 +1,109 @@
+/*
+ * BatteryVoltageTrend.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef BATTERYVOLTAGETREND_H_
+#define BATTERYVOLTAGETREND_H_
+
+/**
+ * Maximum number of samples the trend is fitted over (8 bytes of RAM each, at least 2), define it in the build to override.
+ */
+#if !defined (BATTERY_TREND_WINDOW_SIZE)
+#if defined (ARDUINO)
+#define BATTERY_TREND_WINDOW_SIZE 8
+#else
+#define BATTERY_TREND_WINDOW_SIZE 32
+#endif
+#endif
+
+/**
+ * Least-squares voltage trend over a sliding window of recent samples, with level crossing prediction.
+ *
+ * The regression sums are updated incrementally, each update() adds the new sample and removes the one
+ * leaving the window in a constant number of operations. To bound the rounding drift of the running sums
+ * they are recomputed from the window (and the time origin moved to its oldest sample) once per window length.
+ */
+class BatteryVoltageTrend
+{
+public:
+  /**
+   * Constructor.
+   * @param windowSize Number of samples the slope is fitted over [2..s_MAX_WINDOW_SIZE].
+   */
+  BatteryVoltageTrend(unsigned int windowSize = s_DEFAULT_WINDOW_SIZE);
+
+  /**
+   * Select the window size, resets the trend.
+   */
+  void configure(unsigned int windowSize);
+
+  /**
+   * Discard all samples.
+   */
+  void reset();
+
+  /**
+   * Feed one voltage sample.
+   * @param voltage Voltage [V].
+   * @param timestampMillis Time of the sample [ms].
+   */
+  void update(float voltage, unsigned long timestampMillis);
+
+  /**
+   * A slope is available: at least two samples spanning some time.
+   */
+  bool isValid();
+
+  /**
+   * Fitted voltage change rate [V/s], negative: falling, 0 if not valid.
+   */
+  float slope();
+
+  /**
+   * Predict when the fitted voltage reaches a level.
+   * @param level Voltage level [V].
+   * @return Time from the latest sample on [s], 0 if already at or below the level,
+   *         s_TIME_UNKNOWN if not valid or not falling.
+   */
+  float timeToLevel(float level);
+
+  static const float s_TIME_UNKNOWN;                        /// level crossing not predictable
+  static const unsigned int s_MAX_WINDOW_SIZE = BATTERY_TREND_WINDOW_SIZE;
+  static const unsigned int s_DEFAULT_WINDOW_SIZE = 8;                    /// limited to s_MAX_WINDOW_SIZE
+
+private:
+  /**
+   * Re-compute the sums from the window, relative to the oldest sample's time.
+   */
+  void recompute();
+
+  /**
+   * Update the slope and the fitted voltage of the latest sample from the sums.
+   */
+  void fit();
+
+private:
+  float m_voltages[s_MAX_WINDOW_SIZE];              /// [V]
+  unsigned long m_timestamps[s_MAX_WINDOW_SIZE];    /// [ms]
+  unsigned int m_windowSize;
+  unsigned int m_next;                              /// slot the next sample is written to
+  unsigned int m_size;                              /// number of samples in the window
+  unsigned int m_numUpdates;                        /// updates since the latest recompute()
+  unsigned long m_originMillis;                     /// time the sums' time axis starts at [ms]
+  float m_sumT;                                     /// sum of t [s]
+  float m_sumV;                                     /// sum of v [V]
+  float m_sumTT;                                    /// sum of t * t [s^2]
+  float m_sumTV;                                    /// sum of t * v [V s]
+  bool m_isValid;
+  float m_slope;                                    /// [V/s]
+  float m_fitVoltage;                               /// fitted voltage at the latest sample [V]
+
+private: // forbidden default functions
+  BatteryVoltageTrend& operator = (const BatteryVoltageTrend& src); // assignment operator
+  BatteryVoltageTrend(const BatteryVoltageTrend& src);              // copy constructor
+};
+
+#endif /* BATTERYVOLTAGETREND_H_ */
@@ -0,0 +1,219 @@
+/*
+ * StaticBattery.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef STATICBATTERY_H_
+#define STATICBATTERY_H_
+
+#include "SpinTimer.h"
+#include "Battery.h"
+#include "BatteryVoltageConverter.h"
+#include "BatteryVoltageEvalTable.h"
+
+/*
+ * Header-only, statically polymorphic variant of the Battery component.
+ *
+ * StaticBattery<AdapterT, ConfigT> behaves like Battery with a BatteryAdapter, but stores all of its
+ * state (evaluation FSM, timers and timer actions) inline - no heap allocation - and calls the adapter
+ * through static dispatch, so the compiler can inline the whole read-convert-compare path.
+ */
+
+//-----------------------------------------------------------------------------
+
+/**
+ * CRTP base for adapters used with StaticBattery, provides the same defaults as BatteryAdapter.
+ * The derived class must implement: unsigned int readRawBattSenseValue();
+ */
+template <class DerivedT>
+class StaticBatteryAdapter
+{
+public:
+  void notifyBattVoltageOk()                      { derived().notifyBattStateAnyChange(); }
+  void notifyBattVoltageBelowWarnThreshold()      { derived().notifyBattStateAnyChange(); }
+  void notifyBattVoltageBelowStopThreshold()      { derived().notifyBattStateAnyChange(); }
+  void notifyBattVoltageBelowShutdownThreshold()  { derived().notifyBattStateAnyChange(); }
+  void notifyBattStateAnyChange()                 { }
+  float readBattVoltageSenseFactor()              { return 2.0; }
+  float getVAdcFullrange()                        { return BatteryAdcDefaults::s_V_ADC_FULLRANGE; }
+  unsigned int getNAdcFullrange()                 { return BatteryAdcDefaults::s_N_ADC_FULLRANGE; }
+
+protected:
+  StaticBatteryAdapter() { }
+
+  DerivedT& derived()
+  {
+    return *static_cast<DerivedT*>(this);
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Default compile time configuration, same values as the Battery defaults.
+ */
+struct StaticBatteryDefaultConfig
+{
+  static constexpr float battWarnThreshd = 6.5;           /// Battery Voltage Warn Threshold [V]
+  static constexpr float battStopThrshd  = 6.3;           /// Battery Voltage Stop Actors Threshold [V]
+  static constexpr float battShutThrshd  = 6.1;           /// Battery Voltage Shutdown Threshold [V]
+  static constexpr float battHyst        = 0.3;           /// Battery Voltage Hysteresis around Threshold levels [V]
+  static constexpr unsigned int startupTime = 500;        /// startup timer time [ms]
+  static constexpr unsigned int pollTime    = 5000;       /// status poll interval [ms]
+};
+
+//-----------------------------------------------------------------------------
+
+template <class AdapterT, class ConfigT = StaticBatteryDefaultConfig>
+class StaticBattery
+{
+public:
+  /**
+   * Constructor.
+   * @param adapter Specific adapter object, must outlive the StaticBattery.
+   */
+  explicit StaticBattery(AdapterT& adapter)
+  : m_adapter(adapter)
+  , m_startupAction(this)
+  , m_evalAction(this)
+  , m_startupTimer(ConfigT::startupTime, &m_startupAction, SpinTimer::IS_NON_RECURRING, SpinTimer::IS_AUTOSTART)
+  , m_pollTimer(ConfigT::pollTime, &m_evalAction, SpinTimer::IS_RECURRING, SpinTimer::IS_NON_AUTOSTART)
+  , m_evalStatusTimer(0, &m_evalAction, SpinTimer::IS_NON_RECURRING, SpinTimer::IS_NON_AUTOSTART)
+  , m_evalFsm()
+  , m_batteryVoltage(0.0)
+  , m_battVoltageConvCoeff(0.0)
+  {
+    BatteryThresholdConfig batteryThresholdConfig = { ConfigT::battWarnThreshd, ConfigT::battStopThrshd, ConfigT::battShutThrshd, ConfigT::battHyst };
+    m_evalFsm.setThresholdConfig(batteryThresholdConfig);
+    battVoltageSensFactorChanged();
+  }
+
+  AdapterT& adapter()
+  {
+    return m_adapter;
+  }
+
+  /**
+   * Notify application startup (after startup timer expired).
+   */
+  void startup()
+  {
+    battVoltageSensFactorChanged();
+    evaluateBatteryStateAsync();
+    m_pollTimer.start(ConfigT::pollTime);
+  }
+
+  /**
+   * Read battery voltage and evaluate battery status.
+   */
+  void evaluateBatteryState()
+  {
+    m_batteryVoltage = BatteryVoltageConverter::convert(m_adapter.readRawBattSenseValue(), m_battVoltageConvCoeff);
+    if (m_evalFsm.evaluate(m_batteryVoltage))
+    {
+      notifyStateEntry(m_evalFsm.state());
+    }
+  }
+
+  /**
+   * Evaluate Battery state, execute asynchronously (detached from the caller)
+   */
+  void evaluateBatteryStateAsync()
+  {
+    m_evalStatusTimer.start(0);
+  }
+
+  /**
+   * Notify Battery Voltage Sense Factor has changed, re-read it from the adapter.
+   */
+  void battVoltageSensFactorChanged()
+  {
+    m_battVoltageConvCoeff = BatteryVoltageConverter::conversionCoefficient(m_adapter.readBattVoltageSenseFactor(), m_adapter.getVAdcFullrange(), m_adapter.getNAdcFullrange());
+  }
+
+  float getBatteryVoltage()
+  {
+    return m_batteryVoltage;
+  }
+
+  bool isBattVoltageOk()
+  {
+    return BattStateOk == m_evalFsm.state();
+  }
+
+  bool isBattVoltageBelowWarnThreshold()
+  {
+    return BattStateVoltageBelowWarn <= m_evalFsm.state();
+  }
+
+  bool isBattVoltageBelowStopThreshold()
+  {
+    return BattStateVoltageBelowStop <= m_evalFsm.state();
+  }
+
+  bool isBattVoltageBelowShutdownThreshold()
+  {
+    return BattStateVoltageBelowShutdown == m_evalFsm.state();
+  }
+
+  const char* getCurrentStateName()
+  {
+    return BatteryVoltageEvalTableFsm::stateName(m_evalFsm.state());
+  }
+
+  const char* getPreviousStateName()
+  {
+    return BatteryVoltageEvalTableFsm::stateName(m_evalFsm.previousState());
+  }
+
+private:
+  void notifyStateEntry(BattVoltageEvalStateId state)
+  {
+    switch (state)
+    {
+      case BattStateOk:                   m_adapter.notifyBattVoltageOk(); break;
+      case BattStateVoltageBelowWarn:     m_adapter.notifyBattVoltageBelowWarnThreshold(); break;
+      case BattStateVoltageBelowStop:     m_adapter.notifyBattVoltageBelowStopThreshold(); break;
+      case BattStateVoltageBelowShutdown: m_adapter.notifyBattVoltageBelowShutdownThreshold(); break;
+      case BattStateUnknown:
+      default:                            break;
+    }
+  }
+
+  class StartupAction : public SpinTimerAction
+  {
+  public:
+    explicit StartupAction(StaticBattery* battery) : m_battery(battery) { }
+    void timeExpired() { m_battery->startup(); }
+  private:
+    StaticBattery* m_battery;
+  };
+
+  class EvalAction : public SpinTimerAction
+  {
+  public:
+    explicit EvalAction(StaticBattery* battery) : m_battery(battery) { }
+    void timeExpired() { m_battery->evaluateBatteryState(); }
+  private:
+    StaticBattery* m_battery;
+  };
+
+private:
+  AdapterT& m_adapter;
+  StartupAction m_startupAction;
+  EvalAction m_evalAction;
+  SpinTimer m_startupTimer;
+  SpinTimer m_pollTimer;
+  SpinTimer m_evalStatusTimer;
+  BatteryVoltageEvalTableFsm m_evalFsm;
+  float m_batteryVoltage;
+  float m_battVoltageConvCoeff;
+
+private: // forbidden default functions
+  StaticBattery& operator = (const StaticBattery& src); // assignment operator
+  StaticBattery(const StaticBattery& src);              // copy constructor
+};
+
+#endif /* STATICBATTERY_H_ */
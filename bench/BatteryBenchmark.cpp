@@ -0,0 +1,420 @@
+/*
+ * BatteryBenchmark.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "Battery.h"
+#include "BatteryEvalRuntime.h"
+#include "BatteryFleet.h"
+#include "BatteryTelemetryLog.h"
+#include "BatteryTraceReplay.h"
+#include "BatteryVoltageConverter.h"
+#include "StaticBattery.h"
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Adapter replaying a fixed cycle of raw values, counting the notifications.
+ */
+class BenchAdapter : public BatteryAdapter
+{
+public:
+  BenchAdapter()
+  : m_rawValues()
+  , m_index(0)
+  , m_numNotifications(0)
+  , m_uptimeMillis(0)
+  { }
+
+  void setRawValues(const std::vector<unsigned int>& rawValues)
+  {
+    m_rawValues = rawValues;
+    m_index = 0;
+  }
+
+  unsigned int readRawBattSenseValue()
+  {
+    unsigned int rawValue = m_rawValues[m_index];
+    m_index = (m_index + 1 < m_rawValues.size()) ? m_index + 1 : 0;
+    return rawValue;
+  }
+
+  void notifyBattStateAnyChange()
+  {
+    m_numNotifications++;
+  }
+
+  float getVAdcFullrange()
+  {
+    return s_V_ADC_FULLRANGE;
+  }
+
+  unsigned int getNAdcFullrange()
+  {
+    return s_N_ADC_FULLRANGE;
+  }
+
+  unsigned long numNotifications()
+  {
+    return m_numNotifications;
+  }
+
+  /**
+   * Virtual clock, one poll period per read: the host clock read would dominate the figures.
+   */
+  unsigned long getUptimeMillis()
+  {
+    m_uptimeMillis += 5000;
+    return m_uptimeMillis;
+  }
+
+  /**
+   * Raw ADC count for a Battery Voltage, with the default sense factor.
+   */
+  static unsigned int rawValue(float batteryVoltage)
+  {
+    return static_cast<unsigned int>(batteryVoltage / BatteryVoltageConverter::conversionCoefficient(2.0, s_V_ADC_FULLRANGE, s_N_ADC_FULLRANGE));
+  }
+
+  static const float s_V_ADC_FULLRANGE;
+  static const unsigned int s_N_ADC_FULLRANGE;
+
+private:
+  std::vector<unsigned int> m_rawValues;
+  unsigned int m_index;
+  unsigned long m_numNotifications;
+  unsigned long m_uptimeMillis;
+};
+
+const float BenchAdapter::s_V_ADC_FULLRANGE = 3.1;
+const unsigned int BenchAdapter::s_N_ADC_FULLRANGE = 4095;
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Statically dispatched counterpart of the BenchAdapter.
+ */
+class StaticBenchAdapter : public StaticBatteryAdapter<StaticBenchAdapter>
+{
+public:
+  StaticBenchAdapter()
+  : m_rawValues()
+  , m_index(0)
+  , m_numNotifications(0)
+  { }
+
+  void setRawValues(const std::vector<unsigned int>& rawValues)
+  {
+    m_rawValues = rawValues;
+    m_index = 0;
+  }
+
+  unsigned int readRawBattSenseValue()
+  {
+    unsigned int rawValue = m_rawValues[m_index];
+    m_index = (m_index + 1 < m_rawValues.size()) ? m_index + 1 : 0;
+    return rawValue;
+  }
+
+  void notifyBattStateAnyChange()
+  {
+    m_numNotifications++;
+  }
+
+  float getVAdcFullrange()
+  {
+    return BenchAdapter::s_V_ADC_FULLRANGE;
+  }
+
+  unsigned int getNAdcFullrange()
+  {
+    return BenchAdapter::s_N_ADC_FULLRANGE;
+  }
+
+  unsigned long numNotifications()
+  {
+    return m_numNotifications;
+  }
+
+private:
+  std::vector<unsigned int> m_rawValues;
+  unsigned int m_index;
+  unsigned long m_numNotifications;
+};
+
+//-----------------------------------------------------------------------------
+
+class BenchFleetAdapter : public BatteryFleetAdapter
+{
+public:
+  BenchFleetAdapter()
+  : m_numNotifications(0)
+  { }
+
+  void notifyBattStateChange(unsigned int index, BattVoltageEvalStateId previousState, BattVoltageEvalStateId state)
+  {
+    m_numNotifications++;
+  }
+
+  unsigned long m_numNotifications;
+};
+
+//-----------------------------------------------------------------------------
+
+static double nowNanos()
+{
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static void report(const char* name, double nanos, unsigned long numOperations)
+{
+  printf("%-56s %10.2f ns/op  (%lu ops)\n", name, nanos / numOperations, numOperations);
+}
+
+static volatile unsigned long s_sink = 0;   /// keeps results alive
+
+//-----------------------------------------------------------------------------
+
+static void benchEvaluateStatus(const char* name, bool isTableEngine, const std::vector<unsigned int>& rawValues, unsigned long iterations)
+{
+  BenchAdapter adapter;
+  adapter.setRawValues(rawValues);
+  Battery battery(&adapter);
+  battery.setTableEvalEngine(isTableEngine);
+  battery.evaluateBatteryState();   // leave BattUnknown
+
+  double start = nowNanos();
+  for (unsigned long i = 0; i < iterations; i++)
+  {
+    battery.evaluateBatteryState();
+  }
+  report(name, nowNanos() - start, iterations);
+  s_sink += adapter.numNotifications();
+}
+
+static void benchStaticBattery(const char* name, const std::vector<unsigned int>& rawValues, unsigned long iterations)
+{
+  StaticBenchAdapter adapter;
+  adapter.setRawValues(rawValues);
+  StaticBattery<StaticBenchAdapter> battery(adapter);
+  battery.evaluateBatteryState();   // leave BattUnknown
+
+  double start = nowNanos();
+  for (unsigned long i = 0; i < iterations; i++)
+  {
+    battery.evaluateBatteryState();
+  }
+  report(name, nowNanos() - start, iterations);
+  s_sink += adapter.numNotifications();
+}
+
+static void benchGetCurrentStateName(unsigned long iterations)
+{
+  BenchAdapter adapter;
+  adapter.setRawValues(std::vector<unsigned int>(1, BenchAdapter::rawValue(7.0)));
+  Battery battery(&adapter);
+  battery.evaluateBatteryState();
+
+  double start = nowNanos();
+  for (unsigned long i = 0; i < iterations; i++)
+  {
+    s_sink += battery.getCurrentStateName()[0];
+  }
+  report("Battery::getCurrentStateName()", nowNanos() - start, iterations);
+}
+
+static void benchScaling(unsigned int numInstances, unsigned long minEvaluations, bool isRuntime)
+{
+  std::vector<BenchAdapter*> adapters;
+  std::vector<Battery*> batteries;
+  std::vector<unsigned int> rawValues(1, BenchAdapter::rawValue(7.0));
+  BatteryEvalRuntime* instanceRuntime = isRuntime ? new BatteryEvalRuntime() : 0;
+  for (unsigned int i = 0; i < numInstances; i++)
+  {
+    BenchAdapter* adapter = new BenchAdapter();
+    adapter->setRawValues(rawValues);
+    adapters.push_back(adapter);
+    batteries.push_back(new Battery(adapter));
+    if (0 != instanceRuntime)
+    {
+      instanceRuntime->attachBattery(batteries.back());
+    }
+  }
+
+  unsigned long rounds = (minEvaluations + numInstances - 1) / numInstances;
+  double start = nowNanos();
+  for (unsigned long r = 0; r < rounds; r++)
+  {
+    if (0 != instanceRuntime)
+    {
+      instanceRuntime->evaluateAll();
+    }
+    else
+    {
+      for (unsigned int i = 0; i < numInstances; i++)
+      {
+        batteries[i]->evaluateBatteryState();
+      }
+    }
+  }
+  char name[80];
+  snprintf(name, sizeof(name), "%s, %u instances", (0 != instanceRuntime) ? "BatteryEvalRuntime::evaluateAll()" : "Battery::evaluateBatteryState()", numInstances);
+  report(name, nowNanos() - start, rounds * numInstances);
+
+  delete instanceRuntime;
+  for (unsigned int i = 0; i < numInstances; i++)
+  {
+    delete batteries[i];
+    delete adapters[i];
+  }
+}
+
+static void benchFleet(unsigned int numInstances, unsigned long minEvaluations)
+{
+  BenchFleetAdapter adapter;
+  BatteryFleet fleet(numInstances, BenchAdapter::s_V_ADC_FULLRANGE, BenchAdapter::s_N_ADC_FULLRANGE, &adapter);
+  BatteryThresholdConfig config = { Battery::s_BATT_WARN_THRSHD, Battery::s_BATT_STOP_THRSHD, Battery::s_BATT_SHUT_THRSHD, Battery::s_BATT_HYST };
+  for (unsigned int i = 0; i < numInstances; i++)
+  {
+    fleet.addBattery(2.0, config);
+    fleet.setRawBattSenseValue(i, BenchAdapter::rawValue(7.0));
+  }
+
+  unsigned long rounds = (minEvaluations + numInstances - 1) / numInstances;
+  double start = nowNanos();
+  for (unsigned long r = 0; r < rounds; r++)
+  {
+    s_sink += fleet.evaluate();
+  }
+  char name[80];
+  snprintf(name, sizeof(name), "BatteryFleet::evaluate(), %u packs", numInstances);
+  report(name, nowNanos() - start, rounds * numInstances);
+}
+
+static void benchConverter(unsigned int count, unsigned long minConversions)
+{
+  std::vector<unsigned int> raw(count, BenchAdapter::rawValue(7.0));
+  std::vector<float> voltages(count);
+  float coefficient = BatteryVoltageConverter::conversionCoefficient(2.0, BenchAdapter::s_V_ADC_FULLRANGE, BenchAdapter::s_N_ADC_FULLRANGE);
+  unsigned long rounds = (minConversions + count - 1) / count;
+  double start = nowNanos();
+  for (unsigned long r = 0; r < rounds; r++)
+  {
+    BatteryVoltageConverter::convert(&raw[0], coefficient, &voltages[0], count);
+    s_sink += static_cast<unsigned long>(voltages[r % count]);
+  }
+  char name[80];
+  snprintf(name, sizeof(name), "BatteryVoltageConverter::convert() [%s], %u samples", BatteryVoltageConverter::instructionSet(), count);
+  report(name, nowNanos() - start, rounds * count);
+}
+
+static void benchTraceReplay(const char* path)
+{
+  // one year of 5 s samples, slowly discharging and recharging
+  const unsigned long numSamples = 365UL * 24 * 3600 / 5;
+  std::vector<uint16_t> samples(numSamples);
+  unsigned int high = BenchAdapter::rawValue(7.2);
+  unsigned int low = BenchAdapter::rawValue(5.9);
+  for (unsigned long i = 0; i < numSamples; i++)
+  {
+    unsigned long phase = i % 20000;
+    unsigned long ramp = (phase < 10000) ? phase : 20000 - phase;
+    samples[i] = static_cast<uint16_t>(high - (high - low) * ramp / 10000);
+  }
+  if (!BatteryTraceReplay::writeTrace(path, 5000, 0, &samples[0], numSamples))
+  {
+    printf("BatteryTraceReplay: failed to write %s\n", path);
+    return;
+  }
+
+  BatteryThresholdConfig config = { Battery::s_BATT_WARN_THRSHD, Battery::s_BATT_STOP_THRSHD, Battery::s_BATT_SHUT_THRSHD, Battery::s_BATT_HYST };
+  BatteryTraceReplay replay(2.0, BenchAdapter::s_V_ADC_FULLRANGE, BenchAdapter::s_N_ADC_FULLRANGE, config);
+  double start = nowNanos();
+  if (replay.open(path))
+  {
+    s_sink += replay.replay();
+    report("BatteryTraceReplay::replay(), one year of 5 s samples", nowNanos() - start, replay.numSamples());
+    printf("%-56s %10.2f ms\n", "  total replay time", (nowNanos() - start) / 1000000.0);
+  }
+  replay.close();
+  remove(path);
+}
+
+static void benchTelemetryLog(const char* basePath, unsigned long numRecords)
+{
+  const unsigned long recordsPerSegment = 1UL << 20;
+  BatteryTelemetryLog log(basePath, recordsPerSegment, 2);
+  if (!log.open())
+  {
+    printf("BatteryTelemetryLog: failed to open %s\n", basePath);
+    return;
+  }
+  BatteryTelemetryRecord record = { 0, 0, BattStateOk, 0, 0.0, 0, 0 };
+  double start = nowNanos();
+  for (unsigned long i = 0; i < numRecords; i++)
+  {
+    record.timestampMillis = static_cast<uint64_t>(i);
+    record.rawBattSenseValue = static_cast<uint16_t>(i);
+    log.record(record);
+  }
+  report("BatteryTelemetryLog::record()", nowNanos() - start, numRecords);
+  unsigned long lastSegment = log.segmentNumber();
+  log.close();
+  for (unsigned long i = 0; i <= lastSegment; i++)
+  {
+    char path[256];
+    snprintf(path, sizeof(path), "%s.%lu", basePath, i);
+    remove(path);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+  // optional argument: scale of the number of iterations, default 1.0
+  double scale = (argc > 1) ? atof(argv[1]) : 1.0;
+  unsigned long iterations = static_cast<unsigned long>(2000000 * scale);
+  if (0 == iterations)
+  {
+    iterations = 1;
+  }
+
+  std::vector<unsigned int> steady(1, BenchAdapter::rawValue(7.0));
+  std::vector<unsigned int> toggling;
+  toggling.push_back(BenchAdapter::rawValue(6.4));   // BattOk -> BattVoltageBelowWarn
+  toggling.push_back(BenchAdapter::rawValue(7.0));   // BattVoltageBelowWarn -> BattOk
+
+  benchEvaluateStatus("evaluateStatus(), no transition, state classes", false, steady, iterations);
+  benchEvaluateStatus("evaluateStatus(), no transition, table engine", true, steady, iterations);
+  benchEvaluateStatus("evaluateStatus(), transition + notify, state classes", false, toggling, iterations);
+  benchEvaluateStatus("evaluateStatus(), transition + notify, table engine", true, toggling, iterations);
+  benchStaticBattery("StaticBattery::evaluateBatteryState(), no transition", steady, iterations);
+  benchStaticBattery("StaticBattery::evaluateBatteryState(), transition + notify", toggling, iterations);
+  benchGetCurrentStateName(iterations);
+
+  const unsigned int numInstances[] = { 1, 10, 100, 1000, 10000, 100000 };
+  for (unsigned int i = 0; i < sizeof(numInstances) / sizeof(numInstances[0]); i++)
+  {
+    benchScaling(numInstances[i], iterations, false);
+  }
+  for (unsigned int i = 0; i < sizeof(numInstances) / sizeof(numInstances[0]); i++)
+  {
+    benchScaling(numInstances[i], iterations, true);
+  }
+  for (unsigned int i = 0; i < sizeof(numInstances) / sizeof(numInstances[0]); i++)
+  {
+    benchFleet(numInstances[i], iterations * 10);
+  }
+  benchConverter(1024, iterations * 10);
+  benchTraceReplay("BatteryBenchmark.trace");
+  benchTelemetryLog("BatteryBenchmark.telemetry", iterations);
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * SpinTimer.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#include <chrono>
+#include "SpinTimer.h"
+
+static SpinTimer* s_firstTimer = 0;   /// head of the doubly linked list of all existing timers
+
+SpinTimer::SpinTimer(unsigned long timeMillis, SpinTimerAction* action, bool isRecurring, bool isAutostart)
+: m_action(action)
+, m_isRecurring(isRecurring)
+, m_isRunning(false)
+, m_isExpiredFlag(false)
+, m_timeMillis(timeMillis)
+, m_startMillis(0)
+, m_next(s_firstTimer)
+, m_previous(0)
+{
+  if (0 != s_firstTimer)
+  {
+    s_firstTimer->m_previous = this;
+  }
+  s_firstTimer = this;
+  if (isAutostart)
+  {
+    start();
+  }
+}
+
+SpinTimer::~SpinTimer()
+{
+  if (0 != m_previous)
+  {
+    m_previous->m_next = m_next;
+  }
+  else
+  {
+    s_firstTimer = m_next;
+  }
+  if (0 != m_next)
+  {
+    m_next->m_previous = m_previous;
+  }
+  m_action = 0;
+}
+
+void SpinTimer::attachAction(SpinTimerAction* action)
+{
+  m_action = action;
+}
+
+SpinTimerAction* SpinTimer::action()
+{
+  return m_action;
+}
+
+bool SpinTimer::isRecurring()
+{
+  return m_isRecurring;
+}
+
+bool SpinTimer::isRunning()
+{
+  return m_isRunning;
+}
+
+bool SpinTimer::isExpired()
+{
+  bool isExpired = m_isExpiredFlag;
+  m_isExpiredFlag = false;
+  return isExpired;
+}
+
+void SpinTimer::start()
+{
+  m_startMillis = uptimeMillis();
+  m_isRunning = true;
+}
+
+void SpinTimer::start(unsigned long timeMillis)
+{
+  m_timeMillis = timeMillis;
+  start();
+}
+
+void SpinTimer::cancel()
+{
+  m_isRunning = false;
+}
+
+void SpinTimer::tick()
+{
+  if (m_isRunning && (uptimeMillis() - m_startMillis >= m_timeMillis))
+  {
+    if (m_isRecurring)
+    {
+      m_startMillis += m_timeMillis;
+    }
+    else
+    {
+      m_isRunning = false;
+    }
+    m_isExpiredFlag = true;
+    if (0 != m_action)
+    {
+      m_action->timeExpired();
+    }
+  }
+}
+
+unsigned long SpinTimer::uptimeMillis()
+{
+  return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+SpinTimer* SpinTimer::next()
+{
+  return m_next;
+}
+
+void scheduleTimers()
+{
+  SpinTimer* timer = s_firstTimer;
+  while (0 != timer)
+  {
+    SpinTimer* next = timer->next();   // the action might delete its own timer
+    timer->tick();
+    timer = next;
+  }
+}
@@ -0,0 +1,99 @@
+/*
+ * SpinTimer.h
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#ifndef SPINTIMER_H_
+#define SPINTIMER_H_
+
+/*
+ * Host stand-in for the SpinTimer library (https://github.com/dniklaus/spin-timer), providing the API
+ * subset used by the Battery component. Only used by the CMake host build, Arduino builds use the real library.
+ */
+
+//-----------------------------------------------------------------------------
+
+class SpinTimerAction
+{
+public:
+  virtual ~SpinTimerAction() { }
+
+  /**
+   * Timer expired event, called by the SpinTimer when it expires.
+   */
+  virtual void timeExpired() = 0;
+
+protected:
+  SpinTimerAction() { }
+
+private: // forbidden default functions
+  SpinTimerAction& operator = (const SpinTimerAction& src); // assignment operator
+  SpinTimerAction(const SpinTimerAction& src);              // copy constructor
+};
+
+//-----------------------------------------------------------------------------
+
+class SpinTimer
+{
+public:
+  SpinTimer(unsigned long timeMillis, SpinTimerAction* action = 0, bool isRecurring = false, bool isAutostart = false);
+  virtual ~SpinTimer();
+
+  void attachAction(SpinTimerAction* action);
+  SpinTimerAction* action();
+
+  bool isRecurring();
+  bool isRunning();
+
+  /**
+   * Poll the expired flag, the flag is cleared by this call.
+   */
+  bool isExpired();
+
+  void start();
+  void start(unsigned long timeMillis);
+  void cancel();
+
+  /**
+   * Check for expiry, called for all timers by scheduleTimers().
+   */
+  void tick();
+
+  /**
+   * Time base, the monotonic system clock.
+   * @return Uptime [ms].
+   */
+  static unsigned long uptimeMillis();
+
+  SpinTimer* next();
+
+  static const bool IS_NON_RECURRING = false;
+  static const bool IS_RECURRING     = true;
+  static const bool IS_NON_AUTOSTART = false;
+  static const bool IS_AUTOSTART     = true;
+
+private:
+  SpinTimerAction* m_action;
+  bool m_isRecurring;
+  bool m_isRunning;
+  bool m_isExpiredFlag;
+  unsigned long m_timeMillis;
+  unsigned long m_startMillis;
+  SpinTimer* m_next;
+  SpinTimer* m_previous;
+
+private: // forbidden default functions
+  SpinTimer& operator = (const SpinTimer& src); // assignment operator
+  SpinTimer(const SpinTimer& src);              // copy constructor
+};
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Tick all existing SpinTimer objects, to be called from the main loop.
+ */
+void scheduleTimers();
+
+#endif /* SPINTIMER_H_ */
@@ -0,0 +1,584 @@
+/*
+ * BatteryBehaviourTest.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include "Battery.h"
+#include "BatteryTraceReplay.h"
+#include "BatteryTransitionHistory.h"
+#include "BatteryVoltageConverter.h"
+#include "SpinTimer.h"
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Adapter feeding one Battery Voltage per evaluation on a virtual clock, logging the notifications in order:
+ * 'O': Ok, 'W': below warn, 'S': below stop, 'X': below shutdown.
+ */
+class TestAdapter : public BatteryAdapter
+{
+public:
+  TestAdapter()
+  : m_rawValue(0)
+  , m_uptimeMillis(0)
+  , m_notifications()
+  { }
+
+  void setSample(float batteryVoltage, unsigned long uptimeMillis)
+  {
+    m_rawValue = static_cast<unsigned int>(batteryVoltage / BatteryVoltageConverter::conversionCoefficient(2.0, s_V_ADC_FULLRANGE, s_N_ADC_FULLRANGE) + 0.5);
+    m_uptimeMillis = uptimeMillis;
+  }
+
+  unsigned int readRawBattSenseValue()
+  {
+    return m_rawValue;
+  }
+
+  void notifyBattVoltageOk()                     { m_notifications += 'O'; }
+  void notifyBattVoltageBelowWarnThreshold()     { m_notifications += 'W'; }
+  void notifyBattVoltageBelowStopThreshold()     { m_notifications += 'S'; }
+  void notifyBattVoltageBelowShutdownThreshold() { m_notifications += 'X'; }
+
+  float getVAdcFullrange()
+  {
+    return s_V_ADC_FULLRANGE;
+  }
+
+  unsigned int getNAdcFullrange()
+  {
+    return s_N_ADC_FULLRANGE;
+  }
+
+  unsigned long getUptimeMillis()
+  {
+    return m_uptimeMillis;
+  }
+
+  const std::string& notifications()
+  {
+    return m_notifications;
+  }
+
+  static const float s_V_ADC_FULLRANGE;
+  static const unsigned int s_N_ADC_FULLRANGE;
+
+private:
+  unsigned int m_rawValue;
+  unsigned long m_uptimeMillis;
+  std::string m_notifications;
+};
+
+const float TestAdapter::s_V_ADC_FULLRANGE = 5.0;
+const unsigned int TestAdapter::s_N_ADC_FULLRANGE = 1023;
+
+//-----------------------------------------------------------------------------
+
+static unsigned int s_numFailures = 0;
+
+static void check(bool isOk, const char* testName, bool isTableEngine, const char* what)
+{
+  if (!isOk)
+  {
+    printf("FAILED: %s (%s): %s\n", testName, isTableEngine ? "table engine" : "state classes", what);
+    s_numFailures++;
+  }
+}
+
+static void checkNotifications(TestAdapter& adapter, const char* expected, const char* testName, bool isTableEngine)
+{
+  if (adapter.notifications() != expected)
+  {
+    printf("FAILED: %s (%s): notifications \"%s\", expected \"%s\"\n", testName, isTableEngine ? "table engine" : "state classes",
+           adapter.notifications().c_str(), expected);
+    s_numFailures++;
+  }
+}
+
+/**
+ * Evaluate one sample synchronously.
+ */
+static void evaluate(Battery& battery, TestAdapter& adapter, float batteryVoltage, unsigned long uptimeMillis)
+{
+  adapter.setSample(batteryVoltage, uptimeMillis);
+  battery.evaluateBatteryState();
+}
+
+/**
+ * Run the asynchronous evaluations pending on the timers (e.g. confirmation bursts), the virtual clock stands still.
+ */
+static void runTimers()
+{
+  for (unsigned int i = 0; i < 16; i++)
+  {
+    scheduleTimers();
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Thresholds: warn 6.5 V, stop 6.3 V, shutdown 6.1 V, hysteresis 0.3 V (Battery defaults).
+
+static void testQualificationWindow(bool isTableEngine)
+{
+  const char* testName = "qualification window";
+  TestAdapter adapter;
+  Battery battery(&adapter);
+  battery.setTableEvalEngine(isTableEngine);
+  BatteryQualificationConfig qualificationConfig = { 3, 4, 0, true };
+  battery.configureTransitionQualification(qualificationConfig);
+
+  evaluate(battery, adapter, 7.0, 0);       // out of BattStateUnknown, never delayed
+  evaluate(battery, adapter, 6.4, 100);
+  evaluate(battery, adapter, 7.0, 200);
+  evaluate(battery, adapter, 6.4, 300);
+  checkNotifications(adapter, "O", testName, isTableEngine);
+  evaluate(battery, adapter, 6.4, 400);     // 3 of the last 4
+  checkNotifications(adapter, "OW", testName, isTableEngine);
+
+  evaluate(battery, adapter, 7.0, 500);     // single proposal, slides out of the window
+  evaluate(battery, adapter, 6.4, 600);
+  evaluate(battery, adapter, 6.4, 700);
+  evaluate(battery, adapter, 6.4, 800);
+  evaluate(battery, adapter, 7.0, 900);
+  evaluate(battery, adapter, 7.0, 1000);
+  checkNotifications(adapter, "OW", testName, isTableEngine);
+  evaluate(battery, adapter, 7.0, 1100);
+  checkNotifications(adapter, "OWO", testName, isTableEngine);
+  check(battery.isBattVoltageOk(), testName, isTableEngine, "state BattOk");
+}
+
+static void testDwell(bool isTableEngine)
+{
+  const char* testName = "dwell";
+  TestAdapter adapter;
+  Battery battery(&adapter);
+  battery.setTableEvalEngine(isTableEngine);
+  BatteryQualificationConfig qualificationConfig = { 1, 1, 1000, true };
+  battery.configureTransitionQualification(qualificationConfig);
+
+  evaluate(battery, adapter, 7.0, 0);
+  evaluate(battery, adapter, 6.4, 100);
+  evaluate(battery, adapter, 6.4, 600);
+  evaluate(battery, adapter, 6.4, 1099);
+  checkNotifications(adapter, "O", testName, isTableEngine);
+  evaluate(battery, adapter, 6.4, 1100);
+  checkNotifications(adapter, "OW", testName, isTableEngine);
+
+  evaluate(battery, adapter, 7.0, 1200);    // interrupted, restarts the dwell time
+  evaluate(battery, adapter, 6.4, 1300);
+  evaluate(battery, adapter, 7.0, 1400);
+  evaluate(battery, adapter, 7.0, 2399);
+  checkNotifications(adapter, "OW", testName, isTableEngine);
+  evaluate(battery, adapter, 7.0, 2400);
+  checkNotifications(adapter, "OWO", testName, isTableEngine);
+}
+
+static void testCoalescing(bool isTableEngine)
+{
+  const char* testName = "coalescing";
+  for (unsigned int i = 0; i < 2; i++)
+  {
+    bool isCoalescing = (0 != i);
+    TestAdapter adapter;
+    Battery battery(&adapter);
+    battery.setTableEvalEngine(isTableEngine);
+    BatteryQualificationConfig qualificationConfig = { 1, 1, 0, isCoalescing };
+    battery.configureTransitionQualification(qualificationConfig);
+
+    evaluate(battery, adapter, 7.0, 0);
+    evaluate(battery, adapter, 6.4, 100);
+    evaluate(battery, adapter, 6.2, 200);
+    evaluate(battery, adapter, 5.8, 300);
+    evaluate(battery, adapter, 5.8, 400);
+    evaluate(battery, adapter, 5.8, 500);
+    checkNotifications(adapter, isCoalescing ? "OWSX" : "OWSXXX", testName, isTableEngine);
+    const BatteryTransitionHistory* history = battery.getTransitionHistory();
+    check((0 != history) && (4 == history->numRecorded()), testName, isTableEngine, "self-transitions not recorded");
+  }
+}
+
+static void testSelfTransitionKeepsQualification(bool isTableEngine)
+{
+  const char* testName = "self-transition keeps qualification";
+  TestAdapter adapter;
+  Battery battery(&adapter);
+  battery.setTableEvalEngine(isTableEngine);
+  BatteryQualificationConfig qualificationConfig = { 2, 3, 0, false };
+  battery.configureTransitionQualification(qualificationConfig);
+
+  evaluate(battery, adapter, 7.0, 0);
+  evaluate(battery, adapter, 6.4, 100);
+  evaluate(battery, adapter, 6.4, 200);
+  evaluate(battery, adapter, 6.2, 300);
+  evaluate(battery, adapter, 6.2, 400);
+  evaluate(battery, adapter, 5.8, 500);
+  evaluate(battery, adapter, 5.8, 600);
+  checkNotifications(adapter, "OWSX", testName, isTableEngine);
+
+  evaluate(battery, adapter, 6.6, 700);     // recovery proposed
+  evaluate(battery, adapter, 5.8, 800);     // shutdown re-entry in between
+  evaluate(battery, adapter, 6.6, 900);     // 2 of the last 3
+  checkNotifications(adapter, "OWSXXW", testName, isTableEngine);
+  check(battery.isBattVoltageBelowWarnThreshold() && !battery.isBattVoltageBelowStopThreshold(), testName, isTableEngine, "state BattVoltageBelowWarn");
+}
+
+static void testMultiLevel(bool isTableEngine)
+{
+  const char* testName = "multi-level transitions";
+  for (unsigned int i = 0; i < 2; i++)
+  {
+    bool isFastTransitions = (0 != i);
+    TestAdapter adapter;
+    Battery battery(&adapter);
+    battery.setTableEvalEngine(isTableEngine);
+    battery.configureFastTransitions(isFastTransitions, Battery::s_DROP_RATE_LIMIT, 0);
+
+    evaluate(battery, adapter, 7.0, 0);
+    evaluate(battery, adapter, 5.8, 100);     // below all levels at once
+    checkNotifications(adapter, isFastTransitions ? "OWSX" : "OW", testName, isTableEngine);
+    evaluate(battery, adapter, 6.6, 200);     // recovery steps up one level only, also with fast transitions
+    checkNotifications(adapter, isFastTransitions ? "OWSXW" : "OW", testName, isTableEngine);
+  }
+}
+
+static void testConfirmationBurst(bool isTableEngine)
+{
+  const char* testName = "confirmation burst";
+  for (unsigned int i = 0; i < 2; i++)
+  {
+    unsigned int numConfirmations = 2 * i;
+    TestAdapter adapter;
+    Battery battery(&adapter);
+    battery.setTableEvalEngine(isTableEngine);
+    BatteryQualificationConfig qualificationConfig = { 3, 5, 0, true };
+    battery.configureTransitionQualification(qualificationConfig);
+    battery.configureFastTransitions(true, 0.05, numConfirmations);
+
+    evaluate(battery, adapter, 7.0, 0);
+    evaluate(battery, adapter, 7.0, 1000);
+    evaluate(battery, adapter, 6.4, 2000);    // 0.6 V/s
+    checkNotifications(adapter, "O", testName, isTableEngine);
+    runTimers();                              // the confirmations complete the qualification right away
+    checkNotifications(adapter, (0 != numConfirmations) ? "OW" : "O", testName, isTableEngine);
+
+    evaluate(battery, adapter, 6.4, 3000);    // slow from here on, no burst
+    runTimers();
+    checkNotifications(adapter, (0 != numConfirmations) ? "OW" : "O", testName, isTableEngine);
+    evaluate(battery, adapter, 6.4, 4000);
+    checkNotifications(adapter, "OW", testName, isTableEngine);
+  }
+}
+
+/**
+ * Adapter with a configurable signal conversion, fed with raw ADC counts directly.
+ */
+class RawTestAdapter : public TestAdapter
+{
+public:
+  RawTestAdapter(float battVoltageSenseFactor, float vAdcFullrange, unsigned int nAdcFullrange)
+  : m_battVoltageSenseFactor(battVoltageSenseFactor)
+  , m_vAdcFullrange(vAdcFullrange)
+  , m_nAdcFullrange(nAdcFullrange)
+  , m_rawValue(0)
+  { }
+
+  void setRawSample(unsigned int rawValue)
+  {
+    m_rawValue = rawValue;
+  }
+
+  unsigned int readRawBattSenseValue()    { return m_rawValue; }
+  float readBattVoltageSenseFactor()      { return m_battVoltageSenseFactor; }
+  float getVAdcFullrange()                { return m_vAdcFullrange; }
+  unsigned int getNAdcFullrange()         { return m_nAdcFullrange; }
+
+private:
+  float m_battVoltageSenseFactor;
+  float m_vAdcFullrange;
+  unsigned int m_nAdcFullrange;
+  unsigned int m_rawValue;
+};
+
+/**
+ * Sweep every raw count down through all six levels (thresholds and thresholds plus hysteresis) and back up,
+ * one count per sample: the integer evaluation has to notify exactly what the float evaluation notifies.
+ */
+static void testIntegerEvaluationSweep(bool isTableEngine)
+{
+  const char* testName = "integer evaluation sweep";
+  struct SignalConfig
+  {
+    float battVoltageSenseFactor;
+    float vAdcFullrange;
+    unsigned int nAdcFullrange;
+  };
+  const SignalConfig signalConfigs[] = { { 2.0, 5.0, 1023 }, { 3.0, 3.3, 4095 }, { 2.0, 3.1, 4095 }, { 11.0, 1.1, 1023 }, { 2.5, 4.096, 4095 }, { 4.0, 2.048, 65535 } };
+
+  for (unsigned int c = 0; c < sizeof(signalConfigs) / sizeof(signalConfigs[0]); c++)
+  {
+    const SignalConfig& config = signalConfigs[c];
+    RawTestAdapter floatAdapter(config.battVoltageSenseFactor, config.vAdcFullrange, config.nAdcFullrange);
+    RawTestAdapter integerAdapter(config.battVoltageSenseFactor, config.vAdcFullrange, config.nAdcFullrange);
+    Battery floatBattery(&floatAdapter);
+    Battery integerBattery(&integerAdapter);
+    floatBattery.battVoltageSensFactorChanged();
+    integerBattery.battVoltageSensFactorChanged();
+    floatBattery.setTableEvalEngine(isTableEngine);
+    integerBattery.setTableEvalEngine(isTableEngine);
+    integerBattery.setIntegerEvaluation(true);
+
+    // from above the highest level (warn plus hysteresis) down below the lowest one (shutdown) and back up
+    float coefficient = BatteryVoltageConverter::conversionCoefficient(config.battVoltageSenseFactor, config.vAdcFullrange, config.nAdcFullrange);
+    unsigned int rawHigh = static_cast<unsigned int>((Battery::s_BATT_WARN_THRSHD + Battery::s_BATT_HYST + 0.2) / coefficient);
+    unsigned int rawLow = static_cast<unsigned int>((Battery::s_BATT_SHUT_THRSHD - 0.2) / coefficient);
+    bool isSameState = true;
+    for (unsigned int pass = 0; pass < 2; pass++)
+    {
+      for (unsigned int i = 0; i <= rawHigh - rawLow; i++)
+      {
+        unsigned int rawValue = (0 == pass) ? (rawHigh - i) : (rawLow + i);
+        floatAdapter.setRawSample(rawValue);
+        integerAdapter.setRawSample(rawValue);
+        floatBattery.evaluateBatteryState();
+        integerBattery.evaluateBatteryState();
+        if (isSameState && (floatBattery.isBattVoltageOk() != integerBattery.isBattVoltageOk() ||
+                            floatBattery.isBattVoltageBelowWarnThreshold() != integerBattery.isBattVoltageBelowWarnThreshold() ||
+                            floatBattery.isBattVoltageBelowStopThreshold() != integerBattery.isBattVoltageBelowStopThreshold() ||
+                            floatBattery.isBattVoltageBelowShutdownThreshold() != integerBattery.isBattVoltageBelowShutdownThreshold()))
+        {
+          printf("FAILED: %s (%s): ADC %.3f V / %u, raw count %u: states differ\n", testName, isTableEngine ? "table engine" : "state classes",
+                 config.vAdcFullrange, config.nAdcFullrange, rawValue);
+          isSameState = false;
+          s_numFailures++;
+        }
+      }
+    }
+    check(isSameState, testName, isTableEngine, "same state after every sample");
+    if (floatAdapter.notifications() != integerAdapter.notifications())
+    {
+      printf("FAILED: %s (%s): ADC %.3f V / %u: notifications \"%s\" (integer), \"%s\" (float)\n", testName, isTableEngine ? "table engine" : "state classes",
+             config.vAdcFullrange, config.nAdcFullrange, integerAdapter.notifications().c_str(), floatAdapter.notifications().c_str());
+      s_numFailures++;
+    }
+    check(std::string::npos != floatAdapter.notifications().find("OWSX"), testName, isTableEngine, "sweep crosses all levels");
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Pack of two cell channels with a constant cell voltage each.
+ */
+class PackTestAdapter : public TestAdapter
+{
+public:
+  unsigned int getNumCells()
+  {
+    return 2;
+  }
+
+  unsigned int readRawCellSenseValues(unsigned int* buffer, unsigned int count)
+  {
+    for (unsigned int i = 0; i < count; i++)
+    {
+      buffer[i] = s_RAW_CELL_VALUE;
+    }
+    return count;
+  }
+
+  static const unsigned int s_RAW_CELL_VALUE = 800;   // 3.91 V per cell (sense factor 1.0)
+};
+
+static void testPackVoltageConversion()
+{
+  const char* testName = "pack voltage conversion";
+  PackTestAdapter adapter;
+  Battery battery(&adapter);
+  battery.evaluateBatteryState();
+  float packVoltage = 2 * PackTestAdapter::s_RAW_CELL_VALUE * BatteryVoltageConverter::conversionCoefficient(1.0, TestAdapter::s_V_ADC_FULLRANGE, TestAdapter::s_N_ADC_FULLRANGE);
+  check(fabs(battery.getBatteryVoltage() - packVoltage) < 0.001, testName, false, "pack voltage");
+
+  // republished from the raw cell sum, which goes with the cell coefficient, not the pack channel's
+  battery.battVoltageSensFactorChanged();
+  battery.resetConsumption();
+  check(fabs(battery.getBatteryVoltage() - packVoltage) < 0.001, testName, false, "pack voltage after the sense factor change");
+}
+
+static void testExponentialFilterAlpha()
+{
+  const char* testName = "exponential filter alpha";
+  TestAdapter adapter;
+  Battery battery(&adapter);
+  battery.configureSampleFilter(BattFilterExponential, 1, 1, 0.0);   // clamped, must not freeze the estimate
+  BatteryQualificationConfig qualificationConfig = { 1, 1, 0, true };   // no shutdown re-entries
+  battery.configureTransitionQualification(qualificationConfig);
+
+  evaluate(battery, adapter, 7.0, 0);
+  for (unsigned long i = 1; i <= 2000; i++)
+  {
+    evaluate(battery, adapter, 5.8, 100 * i);
+  }
+  checkNotifications(adapter, "OWSX", testName, false);
+}
+
+/**
+ * Adapter with a constant sleep current below 1 mA.
+ */
+class SleepCurrentTestAdapter : public TestAdapter
+{
+public:
+  bool readBattCurrent(float& battCurrent)
+  {
+    battCurrent = s_SLEEP_CURRENT;
+    return true;
+  }
+
+  static const float s_SLEEP_CURRENT;
+};
+
+const float SleepCurrentTestAdapter::s_SLEEP_CURRENT = 0.0004;   // 0.4 mA
+
+static void testSubMilliAmpConsumption()
+{
+  const char* testName = "sub-mA consumption";
+  SleepCurrentTestAdapter adapter;
+  Battery battery(&adapter);
+  for (unsigned long i = 0; i <= 3600; i++)
+  {
+    evaluate(battery, adapter, 7.0, 1000 * i);   // one hour
+  }
+  check(fabs(battery.getConsumedCharge() - 0.4) < 0.001, testName, false, "0.4 mAh");
+  check(fabs(battery.getConsumedEnergy() - 0.0028) < 0.00001, testName, false, "2.8 mWh");
+}
+
+//-----------------------------------------------------------------------------
+
+#if defined (__unix__)
+
+/**
+ * Replay listener logging the events like the TestAdapter, self-transitions in lower case.
+ */
+class TestReplayListener : public BatteryTraceReplayListener
+{
+public:
+  TestReplayListener()
+  : m_events()
+  , m_lastTimestampMillis(0)
+  { }
+
+  void notifyTransition(const BatteryTransitionEvent& event)
+  {
+    static const char s_stateCodes[] = "?OWSX";
+    char code = s_stateCodes[event.state];
+    m_events += (event.previousState == event.state) ? static_cast<char>(code - 'A' + 'a') : code;
+    m_lastTimestampMillis = event.timestampMillis;
+  }
+
+  const std::string& events()
+  {
+    return m_events;
+  }
+
+  unsigned long lastTimestampMillis()
+  {
+    return m_lastTimestampMillis;
+  }
+
+private:
+  std::string m_events;
+  unsigned long m_lastTimestampMillis;
+};
+
+static void testTraceReplay(bool isTableEngine)
+{
+  const char* testName = "trace replay";
+  const float voltages[] = { 7.0, 6.4, 6.4, 6.2, 5.8, 5.8, 5.8, 5.8, 6.6 };
+  const unsigned int numSamples = sizeof(voltages) / sizeof(voltages[0]);
+  float coefficient = BatteryVoltageConverter::conversionCoefficient(2.0, TestAdapter::s_V_ADC_FULLRANGE, TestAdapter::s_N_ADC_FULLRANGE);
+  uint16_t rawSamples[numSamples];
+  for (unsigned int i = 0; i < numSamples; i++)
+  {
+    rawSamples[i] = static_cast<uint16_t>(voltages[i] / coefficient + 0.5);
+  }
+
+  for (unsigned int i = 0; i < 2; i++)
+  {
+    bool isCoalescing = (0 != i);
+    TestReplayListener listener;
+    BatteryThresholdConfig thresholdConfig = { Battery::s_BATT_WARN_THRSHD, Battery::s_BATT_STOP_THRSHD, Battery::s_BATT_SHUT_THRSHD, Battery::s_BATT_HYST };
+    BatteryTraceReplay replay(2.0, TestAdapter::s_V_ADC_FULLRANGE, TestAdapter::s_N_ADC_FULLRANGE, thresholdConfig, &listener);
+    replay.battery()->setTableEvalEngine(isTableEngine);
+    BatteryQualificationConfig qualificationConfig = { 2, 2, 0, isCoalescing };
+    replay.battery()->configureTransitionQualification(qualificationConfig);
+    replay.startClock(0, 1000);
+
+    unsigned long numEvents = replay.replay(rawSamples, numSamples);
+    // the qualification delays each step down by one sample, the shutdown re-entries depend on the coalescing
+    const char* expected = isCoalescing ? "OWSX" : "OWSXx";
+    if (listener.events() != expected)
+    {
+      printf("FAILED: %s (%s): events \"%s\", expected \"%s\"\n", testName, isTableEngine ? "table engine" : "state classes",
+             listener.events().c_str(), expected);
+      s_numFailures++;
+    }
+    check(numEvents == listener.events().length(), testName, isTableEngine, "number of events");
+    check(BattStateVoltageBelowShutdown == replay.state(), testName, isTableEngine, "state BattVoltageBelowShutdown");
+  }
+
+  // trace file starting beyond the 32 bit millisecond range (49.7 days), no qualification: the recovery is notified too
+  const char* path = "BatteryBehaviourTest.trace";
+  const uint64_t startTimestampMillis = 5000000000ULL;
+  TestReplayListener listener;
+  BatteryThresholdConfig thresholdConfig = { Battery::s_BATT_WARN_THRSHD, Battery::s_BATT_STOP_THRSHD, Battery::s_BATT_SHUT_THRSHD, Battery::s_BATT_HYST };
+  BatteryTraceReplay replay(2.0, TestAdapter::s_V_ADC_FULLRANGE, TestAdapter::s_N_ADC_FULLRANGE, thresholdConfig, &listener);
+  replay.battery()->setTableEvalEngine(isTableEngine);
+  bool isOpen = BatteryTraceReplay::writeTrace(path, 1000, startTimestampMillis, rawSamples, numSamples) && replay.open(path);
+  check(isOpen && (numSamples == replay.numSamples()), testName, isTableEngine, "trace file written and mapped");
+  replay.replay();
+  replay.close();
+  remove(path);
+  check(listener.events() == "OWSXxxxW", testName, isTableEngine, "trace file events");
+  if (sizeof(unsigned long) >= sizeof(uint64_t))
+  {
+    check(startTimestampMillis + 8000 == listener.lastTimestampMillis(), testName, isTableEngine, "64 bit trace clock");
+  }
+}
+
+#endif
+
+//-----------------------------------------------------------------------------
+
+int main()
+{
+  for (unsigned int i = 0; i < 2; i++)
+  {
+    bool isTableEngine = (0 != i);
+    testQualificationWindow(isTableEngine);
+    testDwell(isTableEngine);
+    testCoalescing(isTableEngine);
+    testSelfTransitionKeepsQualification(isTableEngine);
+    testMultiLevel(isTableEngine);
+    testConfirmationBurst(isTableEngine);
+    testIntegerEvaluationSweep(isTableEngine);
+#if defined (__unix__)
+    testTraceReplay(isTableEngine);
+#endif
+  }
+  testPackVoltageConversion();
+  testSubMilliAmpConsumption();
+  testExponentialFilterAlpha();
+  runTimers();
+
+  if (0 != s_numFailures)
+  {
+    printf("%u check(s) failed\n", s_numFailures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,341 @@
+/*
+ * BatteryConcurrencyTest.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: niklausd
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "BatterySampleQueue.h"
+#include "BatteryStatusSnapshot.h"
+#include "BatteryTelemetryLog.h"
+
+//-----------------------------------------------------------------------------
+
+static unsigned int s_numFailures = 0;
+
+static void check(bool isOk, const char* testName, const char* what)
+{
+  if (!isOk)
+  {
+    printf("FAILED: %s: %s\n", testName, what);
+    s_numFailures++;
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+/**
+ * A full ring rejects and counts, the accepted samples come out in order.
+ */
+static void testSampleQueueFull()
+{
+  const char* testName = "sample queue, full ring";
+  BatterySampleQueue queue;
+  bool isAccepted = true;
+  for (unsigned int i = 0; i < BatterySampleQueue::s_CAPACITY; i++)
+  {
+    isAccepted = queue.push(i, 10 * i) && isAccepted;
+  }
+  check(isAccepted && (BatterySampleQueue::s_CAPACITY == queue.size()), testName, "capacity accepted");
+  check(!queue.push(1000, 0) && !queue.push(1001, 0), testName, "full ring rejects");
+  check(2 == queue.numRejected(), testName, "rejections counted");
+
+  BatteryRawSample sample;
+  bool isInOrder = true;
+  for (unsigned int i = 0; i < BatterySampleQueue::s_CAPACITY; i++)
+  {
+    isInOrder = queue.pop(sample) && (i == sample.rawBattSenseValue) && (10 * i == sample.timestampMillis) && isInOrder;
+  }
+  check(isInOrder, testName, "samples in order");
+  check(!queue.pop(sample) && (0 == queue.size()), testName, "ring empty");
+  check(queue.push(2000, 0), testName, "accepts again");
+}
+
+struct SampleQueueProducerResult
+{
+  unsigned long numAccepted;
+  unsigned long numRejected;
+  unsigned long long acceptedSum;
+};
+
+static void produceSamples(BatterySampleQueue* queue, unsigned long numSamples, SampleQueueProducerResult* result, std::atomic<bool>* isDone)
+{
+  for (unsigned long i = 1; i <= numSamples; i++)
+  {
+    // every sample is offered once, no retry: a full ring drops it
+    if (queue->push(static_cast<unsigned int>(i), i))
+    {
+      result->numAccepted++;
+      result->acceptedSum += i;
+    }
+    else
+    {
+      result->numRejected++;
+    }
+  }
+  isDone->store(true, std::memory_order_release);
+}
+
+/**
+ * One producer and one consumer thread: no accepted sample is lost or reordered, the rejections are counted.
+ */
+static void testSampleQueueProducerConsumer()
+{
+  const char* testName = "sample queue, producer / consumer";
+  const unsigned long numSamples = 2000000;
+  BatterySampleQueue queue;
+  SampleQueueProducerResult result = { 0, 0, 0 };
+  std::atomic<bool> isDone(false);
+  std::thread producer(produceSamples, &queue, numSamples, &result, &isDone);
+
+  unsigned long numReceived = 0;
+  unsigned long long receivedSum = 0;
+  unsigned long previous = 0;
+  bool isInOrder = true;
+  BatteryRawSample sample;
+  for (;;)
+  {
+    // check the producer first: once done, everything it has pushed can be popped
+    bool isProducerDone = isDone.load(std::memory_order_acquire);
+    bool isPopped = false;
+    while (queue.pop(sample))
+    {
+      isPopped = true;
+      isInOrder = isInOrder && (sample.timestampMillis > previous) && (sample.rawBattSenseValue == sample.timestampMillis);
+      previous = sample.timestampMillis;
+      numReceived++;
+      receivedSum += sample.timestampMillis;
+    }
+    if (isProducerDone)
+    {
+      break;
+    }
+    if (!isPopped)
+    {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  check(isInOrder, testName, "samples in order");
+  check((result.numAccepted == numReceived) && (result.acceptedSum == receivedSum), testName, "no accepted sample lost");
+  check(result.numRejected == queue.numRejected(), testName, "rejections counted");
+  check(numSamples == numReceived + queue.numRejected(), testName, "every sample accepted or rejected");
+}
+
+//-----------------------------------------------------------------------------
+
+/**
+ * Snapshot with every field derived from the publication number, a torn read mixes two numbers.
+ */
+static void fillSnapshot(BatteryStatusSnapshot& snapshot, unsigned long number)
+{
+  float value = static_cast<float>(number % 65536);
+  snapshot.batteryVoltage = value;
+  snapshot.state = static_cast<unsigned char>(number);
+  snapshot.previousState = static_cast<unsigned char>(number + 1);
+  snapshot.sampleSequence = number;
+  snapshot.timestampMillis = ~number;
+  snapshot.rawBattSenseValue = static_cast<unsigned int>(number);
+  snapshot.battVoltageConvCoeff = value;
+  snapshot.isVoltageDeferred = (0 != (number & 1));
+  snapshot.stateOfCharge = value;
+  snapshot.timeToEmpty = value;
+  snapshot.battCurrent = value;
+  snapshot.consumedCharge = value;
+  snapshot.consumedEnergy = value;
+  snapshot.numCells = static_cast<unsigned int>(number);
+  snapshot.minCellVoltage = value;
+  snapshot.maxCellVoltage = value;
+  snapshot.timeToWarn = value;
+  snapshot.timeToStop = value;
+  snapshot.timeToShutdown = value;
+  snapshot.openCircuitVoltage = value;
+  snapshot.internalResistance = value;
+}
+
+static bool isSnapshotConsistent(const BatteryStatusSnapshot& snapshot)
+{
+  BatteryStatusSnapshot expected;
+  fillSnapshot(expected, snapshot.sampleSequence);
+  return (expected.batteryVoltage == snapshot.batteryVoltage) && (expected.state == snapshot.state) &&
+         (expected.previousState == snapshot.previousState) && (expected.timestampMillis == snapshot.timestampMillis) &&
+         (expected.rawBattSenseValue == snapshot.rawBattSenseValue) && (expected.battVoltageConvCoeff == snapshot.battVoltageConvCoeff) &&
+         (expected.isVoltageDeferred == snapshot.isVoltageDeferred) && (expected.stateOfCharge == snapshot.stateOfCharge) &&
+         (expected.timeToEmpty == snapshot.timeToEmpty) && (expected.battCurrent == snapshot.battCurrent) &&
+         (expected.consumedCharge == snapshot.consumedCharge) && (expected.consumedEnergy == snapshot.consumedEnergy) &&
+         (expected.numCells == snapshot.numCells) && (expected.minCellVoltage == snapshot.minCellVoltage) &&
+         (expected.maxCellVoltage == snapshot.maxCellVoltage) && (expected.timeToWarn == snapshot.timeToWarn) &&
+         (expected.timeToStop == snapshot.timeToStop) && (expected.timeToShutdown == snapshot.timeToShutdown) &&
+         (expected.openCircuitVoltage == snapshot.openCircuitVoltage) && (expected.internalResistance == snapshot.internalResistance);
+}
+
+struct SeqlockReaderResult
+{
+  unsigned long numReads;
+  unsigned long numTorn;
+  unsigned long numBackwards;
+};
+
+static void readSnapshots(const BatteryStatusSeqlock* seqlock, std::atomic<bool>* isDone, SeqlockReaderResult* result)
+{
+  unsigned long previous = 0;
+  BatteryStatusSnapshot snapshot;
+  while (!isDone->load(std::memory_order_acquire))
+  {
+    seqlock->read(snapshot);
+    if ((0 != snapshot.sampleSequence) && !isSnapshotConsistent(snapshot))
+    {
+      result->numTorn++;
+    }
+    if (snapshot.sampleSequence < previous)
+    {
+      result->numBackwards++;
+    }
+    previous = snapshot.sampleSequence;
+    result->numReads++;
+  }
+}
+
+/**
+ * One writer publishing continuously, several readers: no reader ever sees a mix of two publications,
+ * nor an older publication after a newer one.
+ */
+static void testSeqlockTornReads()
+{
+  const char* testName = "seqlock, torn reads";
+  const unsigned int numReaders = 3;
+  const unsigned long numPublications = 2000000;
+  BatteryStatusSeqlock seqlock;
+  std::atomic<bool> isDone(false);
+  std::vector<SeqlockReaderResult> results(numReaders);
+  std::vector<std::thread> readers;
+  for (unsigned int i = 0; i < numReaders; i++)
+  {
+    SeqlockReaderResult result = { 0, 0, 0 };
+    results[i] = result;
+    readers.push_back(std::thread(readSnapshots, &seqlock, &isDone, &results[i]));
+  }
+
+  BatteryStatusSnapshot snapshot;
+  for (unsigned long i = 1; i <= numPublications; i++)
+  {
+    fillSnapshot(snapshot, i);
+    seqlock.publish(snapshot);
+  }
+  isDone.store(true, std::memory_order_release);
+
+  unsigned long numReads = 0;
+  unsigned long numTorn = 0;
+  unsigned long numBackwards = 0;
+  for (unsigned int i = 0; i < numReaders; i++)
+  {
+    readers[i].join();
+    numReads += results[i].numReads;
+    numTorn += results[i].numTorn;
+    numBackwards += results[i].numBackwards;
+  }
+  check(0 != numReads, testName, "readers ran");
+  check(0 == numTorn, testName, "no torn snapshot");
+  check(0 == numBackwards, testName, "publications in order");
+  seqlock.read(snapshot);
+  check((numPublications == snapshot.sampleSequence) && isSnapshotConsistent(snapshot), testName, "latest publication read");
+}
+
+//-----------------------------------------------------------------------------
+
+static void writeTelemetry(BatteryTelemetryLog* log, unsigned int channel, unsigned long numRecords)
+{
+  for (unsigned long i = 0; i < numRecords; i++)
+  {
+    BatteryTelemetryRecord record = { i, 0, 0, 0, 0.0, channel, 0 };
+    log->record(record);
+  }
+}
+
+/**
+ * Several writers share one log across segment rotations: every record is stored exactly once,
+ * each writer's records in the order written.
+ */
+static void testTelemetryLogWriters()
+{
+  const char* testName = "telemetry log, concurrent writers";
+  const char* basePath = "BatteryConcurrencyTest.telemetry";
+  const unsigned int numWriters = 4;
+  const unsigned long numRecords = 50000;
+  const unsigned long recordsPerSegment = 4096;
+
+  BatteryTelemetryLog log(basePath, recordsPerSegment, 0, 256);
+  check(log.open(), testName, "log opened");
+  unsigned long firstSegmentNumber = log.segmentNumber();
+  std::vector<std::thread> writers;
+  for (unsigned int i = 0; i < numWriters; i++)
+  {
+    writers.push_back(std::thread(writeTelemetry, &log, i, numRecords));
+  }
+  for (unsigned int i = 0; i < numWriters; i++)
+  {
+    writers[i].join();
+  }
+  check(numWriters * numRecords == log.numRecords(), testName, "number of records");
+  unsigned long lastSegmentNumber = log.segmentNumber();
+  log.close();
+
+  std::vector<unsigned long> nextTimestamp(numWriters, 0);
+  unsigned long numRead = 0;
+  bool isInOrder = true;
+  for (unsigned long segmentNumber = firstSegmentNumber; segmentNumber <= lastSegmentNumber; segmentNumber++)
+  {
+    char path[256];
+    snprintf(path, sizeof(path), "%s.%lu", basePath, segmentNumber);
+    FILE* file = fopen(path, "rb");
+    if (0 == file)
+    {
+      check(false, testName, "segment file readable");
+      continue;
+    }
+    BatteryTelemetrySegmentHeader header;
+    if (1 == fread(&header, sizeof(header), 1, file))
+    {
+      BatteryTelemetryRecord record;
+      for (unsigned long i = 0; (i < header.numRecords) && (1 == fread(&record, sizeof(record), 1, file)); i++)
+      {
+        if ((record.channel >= numWriters) || (record.timestampMillis != nextTimestamp[record.channel]))
+        {
+          isInOrder = false;
+        }
+        else
+        {
+          nextTimestamp[record.channel]++;
+        }
+        numRead++;
+      }
+    }
+    fclose(file);
+    remove(path);
+  }
+  check(numWriters * numRecords == numRead, testName, "records read back");
+  check(isInOrder, testName, "each record once, in order per writer");
+}
+
+//-----------------------------------------------------------------------------
+
+int main()
+{
+  testSampleQueueFull();
+  testSampleQueueProducerConsumer();
+  testSeqlockTornReads();
+  testTelemetryLogWriters();
+
+  if (0 != s_numFailures)
+  {
+    printf("%u check(s) failed\n", s_numFailures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}